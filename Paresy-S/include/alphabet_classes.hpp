@@ -0,0 +1,53 @@
+#ifndef ALPHABET_CLASSES_HPP
+#define ALPHABET_CLASSES_HPP
+
+#include <map>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <rei.h>
+
+namespace paresy_s
+{
+	// Partition of the alphabet into classes of characters that the examples can't tell apart.
+	// Two characters are in one class when swapping them never changes the membership of any example,
+	// i.e. it maps Pos onto Pos and Neg onto Neg. This is an equivalence, so the classes don't depend on the
+	// order the characters are visited in. The partition is dropped when mapping every class to its
+	// representative makes a positive word collide with a negative one.
+	// An RE over the representatives that is consistent with the projected examples stays consistent with
+	// the original ones once every representative is expanded back into the alternation of its class.
+	class AlphabetClasses {
+	public:
+		// Every character is its own class
+		AlphabetClasses();
+
+		AlphabetClasses(const std::vector<std::string>& pos, const std::vector<std::string>& neg);
+
+		bool merged() const { return isMerged; }
+
+		char representative(char c) const { return representatives[static_cast<unsigned char>(c)]; }
+
+		// "(a+b+c)" for a class with several characters, the character itself otherwise
+		std::string expand(char representative) const;
+
+		// The result of an enumeration over the representatives, its costs are the ones of the expanded REs
+		// since an alternation of k characters costs k - 1 alternations and characters more than one
+		Result expandCost(Result result, const unsigned short* costFun) const;
+
+		// Replacing every character by its representative, the duplicates that this creates are removed
+		std::vector<std::string> project(const std::vector<std::string>& words) const;
+
+	private:
+		std::string project(const std::string& word) const;
+		int expansionCost(const std::string& RE, const unsigned short* costFun) const;
+		bool isConsistent(const std::vector<std::string>& pos, const std::vector<std::string>& neg) const;
+		static bool isSwapInvariant(char a, char b, const std::vector<std::string>& words, const std::unordered_set<std::string>& set);
+
+		char representatives[256];
+		std::map<char, std::string> members;
+		bool isMerged = false;
+	};
+}
+
+#endif // ALPHABET_CLASSES_HPP
@@ -0,0 +1,68 @@
+#ifndef BINARY_EXAMPLES_HPP
+#define BINARY_EXAMPLES_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include <rei_util.hpp>
+
+namespace paresy_s
+{
+	// Layout of a binary example set, all the numbers of the header are little-endian
+	// 
+	// | header | pos words | neg words |
+	// 
+	// Every word is a LEB128 length followed by one byte per character, holding its dense code in the alphabet map.
+	// The codes follow the unsigned order of the bytes, like the comparison of std::string, so the shortlex order
+	// of the words is kept.
+	struct BinaryExamplesHeader {
+		char     magic[4];
+		uint32_t version;
+		uint32_t alphabetSize;
+		// reserved, 0
+		uint32_t flags;
+		uint64_t posCount;
+		uint64_t negCount;
+		// byte offsets of the sections from the start of the file
+		uint64_t posOffset;
+		uint64_t negOffset;
+		uint64_t endOffset;
+		// dense code to character
+		char     alphabet[256];
+	};
+
+	// The size of the header in the file
+	constexpr size_t binaryExamplesHeaderSize = 4 + 3 * 4 + 5 * 8 + 256;
+
+	constexpr char binaryExamplesMagic[4] = { 'P', 'R', 'E', 'X' };
+	constexpr uint32_t binaryExamplesVersion = 2;
+
+	// Converting the examples to the binary format
+	bool writeBinaryExamples(const std::string& fileName, const std::vector<std::string>& pos, const std::vector<std::string>& neg);
+
+	// Checking the magic of the file
+	bool isBinaryExamples(const std::string& fileName);
+
+	// Read-only view of a mapped binary example set
+	class BinaryExamples {
+	public:
+		bool open(const std::string& fileName);
+
+		const BinaryExamplesHeader& header() const { return h; }
+
+		void decode(std::vector<std::string>& pos, std::vector<std::string>& neg) const;
+
+	private:
+		void decodeSection(uint64_t offset, uint64_t count, std::vector<std::string>& words) const;
+
+		std::unique_ptr<MappedFile> file;
+		BinaryExamplesHeader h = {};
+	};
+
+	// Reading a binary example set, the same as readFile for the text format
+	bool readBinaryFile(const std::string& fileName, std::vector<std::string>& pos, std::vector<std::string>& neg);
+}
+
+#endif // BINARY_EXAMPLES_HPP
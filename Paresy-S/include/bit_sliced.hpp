@@ -0,0 +1,46 @@
+#ifndef BIT_SLICED_HPP
+#define BIT_SLICED_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <cs.h>
+#include <rei_host.hpp>
+
+namespace paresy_s
+{
+    // A batch of up to 64 CSs stored bit-sliced: slice ix holds the bit ix of every CS of the batch,
+    // the CS k at bit k. Concatenation and star become straight AND/OR sweeps over the guide table
+    // that work on the whole batch at once, with no branch on the data
+    class BitSlicedBatch {
+    public:
+        static constexpr int width = 64;
+
+        BitSlicedBatch(int ICsize);
+
+        // Loading the CSs of the language cache at the given indices
+        void load(const HostLanguageCache& cache, const int* indices, int count);
+        void store(CS* css, int count) const;
+
+        uint64_t& operator[](int ix) { return slices[ix]; }
+        uint64_t operator[](int ix) const { return slices[ix]; }
+
+        int ICsize;
+
+    private:
+        int words;
+        std::vector<uint64_t> slices;
+    };
+
+    // In place transpose of a 64x64 bit matrix, the bit i of row k goes to the bit k of row i
+    void transpose64(uint64_t rows[64]);
+
+    // The star of every CS of the batch
+    void slicedStar(const HostGuideTable& guideTable, BitSlicedBatch& batch);
+
+    // Concatenation of the pairs of the batches, both left.right and right.left like processConcatenate
+    void slicedConcatenate(const HostGuideTable& guideTable, const BitSlicedBatch& left, const BitSlicedBatch& right,
+        BitSlicedBatch& lr, BitSlicedBatch& rl);
+}
+
+#endif // BIT_SLICED_HPP
@@ -10,12 +10,18 @@
 template <class T>
 using Pair = paresy_s::Pair<T>;
 
+#ifdef __CUDACC__
 #define HD __host__ __device__
+#else
+#define HD
+#endif
 
 namespace paresy_s
 {
     template <int N>
     struct bitmask {
+        static constexpr int wordCount = N;
+
         HD bitmask(const uint64_t(&input)[N]) {
             for (size_t i = 0; i < N; ++i) {
                 data[i] = input[i];
@@ -40,6 +46,12 @@ namespace paresy_s
             return bitmask(vals);
         }
 
+        HD bool test(int i) const { return (data[i / 64] >> (i % 64)) & 1; }
+        HD void set(int i) { data[i / 64] |= (uint64_t)1 << (i % 64); }
+
+        HD uint64_t getWord(int i) const { return data[i]; }
+        HD void setWord(int i, uint64_t word) { data[i] = word; }
+
         HD Pair<uint64_t> get128Hash() const {
 
             if (N == 2) 
@@ -0,0 +1,39 @@
+#ifndef CHAR_CLASSES_HPP
+#define CHAR_CLASSES_HPP
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <pair.h>
+
+namespace paresy_s
+{
+	// Character classes that look useful for the examples. These are the sets of characters that are seen
+	// between the same left and right neighbours inside the positive words, plus the whole alphabet.
+	// The most frequent ones come first, at most maxCount are returned
+	std::vector<std::string> usefulCharClasses(const std::vector<std::string>& pos, const std::vector<std::string>& neg, size_t maxCount);
+
+	// "[abc]"
+	std::string charClassString(const std::string& members);
+
+	// The CS of a class is the union of its characters, which sit right after epsilon in the infix closure
+	template <class CS>
+	HD CS charClassCS(const int* memberIndices, int memberCount) {
+		CS cs;
+		for (int i = 0; i < memberCount; ++i) cs |= CS::one() << (memberIndices[i] + 1);
+		return cs;
+	}
+
+	template <class CS>
+	CS charClassCS(const std::set<char>& alphabet, const std::string& members) {
+		std::vector<int> indices;
+		for (auto ch : members) {
+			auto it = alphabet.find(ch);
+			if (it != alphabet.end()) indices.push_back(static_cast<int>(std::distance(alphabet.begin(), it)));
+		}
+		return charClassCS<CS>(indices.data(), static_cast<int>(indices.size()));
+	}
+}
+
+#endif // CHAR_CLASSES_HPP
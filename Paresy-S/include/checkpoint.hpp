@@ -0,0 +1,49 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <cost_intervals.h>
+#include <rei_host.hpp>
+
+namespace paresy_s
+{
+    // A snapshot of the host enumeration at the end of a cost level: the language cache with its indices,
+    // the intervals of the levels, and what decides the last round. The hash set is rebuilt from the cache.
+    // The file is a header followed by a record per save with the REs and the levels that it has added, so a save
+    // only writes the new range and the header, and a load reads the records back through a mapping.
+    // It is keyed on the examples, the seeds, the cost function and the build, a run with other ones doesn't see it
+    class Checkpoint {
+    public:
+        // An empty directory turns the checkpoints off
+        Checkpoint(const std::string& directory, const unsigned short* costFun,
+            const std::vector<std::string>& pos, const std::vector<std::string>& neg, const std::vector<Seed>& seeds);
+
+        bool enabled() const { return !path.empty(); }
+
+        // Writing the snapshot of the sealed level cost. The levels since the last save or load are appended to the
+        // file, the first save writes all of it and replaces the previous one only once it is complete.
+        // The oldest snapshots of the other runs are removed then, CHECKPOINT_KEEP of them are left in the directory
+        bool save(const HostContext& context, const CostIntervals& intervals, int cost, int shortageCost);
+
+        // Loading the snapshot into a context that is past its initial check. Returns the cost of the level it
+        // has been taken at, or -1 when there is none that fits in the context and the intervals
+        int load(HostContext& context, CostIntervals& intervals, int maxCost, int& shortageCost);
+
+        // Removing the snapshot once the enumeration has finished
+        void remove();
+
+    private:
+        void evict() const;
+
+        std::string path;
+        uint64_t key;
+        // The REs and the last level that are in the file, a cost of -1 makes the next save write all of it
+        uint64_t savedCount = 0;
+        int savedCost = -1;
+    };
+}
+
+#endif // CHECKPOINT_HPP
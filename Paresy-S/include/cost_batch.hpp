@@ -0,0 +1,64 @@
+#ifndef COST_BATCH_HPP
+#define COST_BATCH_HPP
+
+#include <vector>
+
+#include <rei.h>
+#include <solution_set.hpp>
+
+namespace paresy_s
+{
+    inline int gcd(int a, int b) { return b == 0 ? a : gcd(b, a % b); }
+
+    // The greatest common divisor of the six costs, a cost function is a multiple of its costs divided by it
+    inline int costScale(const unsigned short* costFun) {
+        int scale = 0;
+        for (int i = 0; i < 6; ++i) scale = gcd(costFun[i], scale);
+        return scale;
+    }
+
+    // Two cost functions that are multiples of the same one order all the REs in the same way, so they have
+    // the same levels and the same solutions, only the costs are scaled. The classes and the slack of the
+    // solutions have a fixed cost though, they don't scale with the rest
+    inline bool sameOrdering(const unsigned short* a, const unsigned short* b) {
+        if (CHAR_CLASS_COST > 0 || SOLUTION_SLACK > 0) return false;
+        int scaleA = costScale(a), scaleB = costScale(b);
+        for (int i = 0; i < 6; ++i) if (a[i] * scaleB != b[i] * scaleA) return false;
+        return true;
+    }
+
+    // The result of an earlier cost function with the costs of the scaled one
+    inline Result scaledResult(const Result& result, const unsigned short* from, const unsigned short* to) {
+        int scaleFrom = costScale(from), scaleTo = costScale(to);
+        Result scaled = result;
+        scaled.REcost = result.REcost / scaleFrom * scaleTo;
+        for (auto& solution : scaled.solutions) solution.REcost = solution.REcost / scaleFrom * scaleTo;
+        return scaled;
+    }
+
+    // Running the enumeration of every cost function of the batch in order. A cost function that orders the REs
+    // like an earlier one that has found a solution within maxCost gets its result, the others are enumerated
+    template <class Enumerate>
+    std::vector<Result> enumerateBatch(const std::vector<const unsigned short*>& costFuns, const unsigned short maxCost, Enumerate enumerate)
+    {
+        std::vector<Result> results;
+
+        for (size_t i = 0; i < costFuns.size(); ++i) {
+
+            bool reused = false;
+            for (size_t j = 0; j < i && !reused; ++j) {
+                if (results[j].RE == "not_found" || !sameOrdering(costFuns[j], costFuns[i])) continue;
+                Result scaled = scaledResult(results[j], costFuns[j], costFuns[i]);
+                if (scaled.REcost > maxCost) continue;
+                results.push_back(scaled);
+                reused = true;
+            }
+
+            if (!reused) results.push_back(enumerate(costFuns[i]));
+        }
+
+        return results;
+    }
+}
+
+#endif // COST_BATCH_HPP
@@ -0,0 +1,105 @@
+#ifndef COST_INTERVALS_H
+#define COST_INTERVALS_H
+
+#include <string>
+#include <tuple>
+#include <climits>
+#include <algorithm>
+
+namespace paresy_s
+{
+    enum class Opreation { Question = 0, Star = 1, Concatenate = 2, Or = 3, And = 4, Count = 5 };
+
+    inline std::string to_string(Opreation op) {
+        switch (op)
+        {
+        case Opreation::Question:
+            return "Q";
+        case Opreation::Star:
+            return "S";
+        case Opreation::Concatenate:
+            return "C";
+        case Opreation::Or:
+            return "O";
+        case Opreation::And:
+            return "A";
+        default:
+            break;
+        }
+        return "";
+    }
+
+    struct Costs
+    {
+        int alpha;
+        int question;
+        int star;
+        int concat;
+        int alternation; //or
+        int intersection;
+        int charClass; // 0 when the character classes are off
+        Costs(const unsigned short* costFun) {
+            alpha = costFun[0];
+            question = costFun[1];
+            star = costFun[2];
+            concat = costFun[3];
+            alternation = costFun[4];
+            intersection = costFun[5];
+            // a class can't be cheaper than a single character
+            charClass = CHAR_CLASS_COST > 0 && CHAR_CLASS_COST < alpha ? alpha : CHAR_CLASS_COST;
+        }
+    };
+
+    // The most expensive level whose REs are read by a level up to maxCost, the levels after it are only
+    // checked for a solution. Question is used instead of Or with epsilon when it isn't more expensive
+    inline int lastReadCost(const Costs& costs, int maxCost) {
+        int step = std::min({ costs.star, costs.alpha + costs.concat, costs.alpha + costs.alternation, costs.alpha + costs.intersection });
+        if (costs.alpha + costs.alternation >= costs.question) step = std::min(step, costs.question);
+        return maxCost - step;
+    }
+
+    // The start of every operation of every cost in the language cache
+    class CostIntervals {
+    public:
+        CostIntervals(const unsigned short maxCost) {
+            opCount = static_cast<int>(Opreation::Count);
+            size = (maxCost + 2) * opCount;
+            startPoints = new int[size]();
+        }
+        ~CostIntervals() {
+            delete[] startPoints;
+        }
+        std::tuple<int, int> Interval(int cost, Opreation start = Opreation::Question, Opreation end = Opreation::And) const {
+            return std::make_tuple(this->start(cost, start), this->end(cost, end));
+        }
+        int& start(int cost, Opreation op) {
+            return startPoints[cost * opCount + static_cast<int>(op)];
+        }
+        int start(int cost, Opreation op) const {
+            return startPoints[cost * opCount + static_cast<int>(op)];
+        }
+        int& end(int cost, Opreation op) {
+            return startPoints[cost * opCount + static_cast<int>(op) + 1];
+        }
+        int end(int cost, Opreation op) const {
+            return startPoints[cost * opCount + static_cast<int>(op) + 1];
+        }
+        // The solution is in the phase op of cost, its end is set to INT_MAX. So are the start points after it,
+        // they are never reached and the start points stay sorted
+        void setFinal(int cost, Opreation op) {
+            std::fill(&end(cost, op), startPoints + size, INT_MAX);
+        }
+        // The cost and the operation of the RE at index, it needs the sorted start points of setFinal
+        void indexToCost(int index, int& cost, Opreation& op) const {
+            int i = static_cast<int>(std::upper_bound(startPoints, startPoints + size, index) - startPoints) - 1;
+            cost = i / opCount;
+            op = static_cast<Opreation>(i % opCount);
+        }
+    private:
+        int* startPoints;
+        int opCount;
+        int size;
+    };
+}
+
+#endif // COST_INTERVALS_H
@@ -0,0 +1,21 @@
+#ifndef CS_H
+#define CS_H
+
+#include <bitmask.h>
+
+// The characteristic sequence, one bit for every word of the infix closure
+#if CS_BIT_COUNT == 0
+using CS = paresy_s::bitmask<2>;
+#elif CS_BIT_COUNT == 1
+using CS = paresy_s::bitmask<4>;
+#elif CS_BIT_COUNT == 2
+using CS = paresy_s::bitmask<8>;
+#elif CS_BIT_COUNT == 3
+using CS = paresy_s::bitmask<16>;
+#elif CS_BIT_COUNT == 4
+using CS = paresy_s::bitmask<32>;
+#else
+using CS = paresy_s::bitmask<64>;
+#endif
+
+#endif // CS_H
@@ -0,0 +1,59 @@
+#ifndef IC_PROJECTION_HPP
+#define IC_PROJECTION_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <rei_host.hpp>
+
+namespace paresy_s
+{
+    // The infix-closure of the examples of a DC run with its guide table, made once for the root problem.
+    // The infix-closure of a sub-problem is the subset of it that holds the infixes of its examples,
+    // so its guide table is projected from the root one instead of being generated again from the words
+    class ICProjection {
+    public:
+        ICProjection(const std::vector<std::string>& pos, const std::vector<std::string>& neg);
+
+        // The infix-closure of a sub-problem, whose examples are among the ones of the root.
+        // It is generated from the words when the root one is too large to be kept
+        HostExamples project(const std::vector<std::string>& pos, const std::vector<std::string>& neg) const;
+
+        // The sub-problem has all the examples of the root
+        bool isRoot(const std::vector<std::string>& pos, const std::vector<std::string>& neg) const { return pos.size() + neg.size() == rootSize; }
+
+    private:
+        friend class SampleClosure;
+
+        bool enabled;
+        size_t rootSize;
+        HostGuideTable guideTable;
+        // The index of every example of the root in the infix-closure
+        std::unordered_map<std::string, int> examples;
+    };
+
+    // The infix-closure of a sample of the examples of the root, which grows a word at a time.
+    // Its size is the number of bits the CSs of the sample take
+    class SampleClosure {
+    public:
+        SampleClosure(const ICProjection& ic, int budget);
+
+        // Adding the word, unless the infix-closure would grow beyond the budget
+        bool add(const std::string& word);
+
+        int size() const { return count; }
+
+    private:
+        const ICProjection& ic;
+        int budget;
+        // with the empty word
+        int count = 1;
+        WordSelection selection;
+        // the infixes themselves, when the root doesn't keep its infix-closure
+        std::unordered_set<std::string> infixes;
+    };
+}
+
+#endif // IC_PROJECTION_HPP
@@ -0,0 +1,148 @@
+#ifndef LANGUAGE_CACHE_H
+#define LANGUAGE_CACHE_H
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include <cs.h>
+#include <pair.h>
+#include <solution_check.h>
+
+namespace paresy_s
+{
+    // The two layouts of the language cache. Both give the CS at an index and the word k of it,
+    // so the operations don't depend on the layout, only on what they read
+
+    // The CSs one after another, the default
+    template <class T>
+    struct PackedView {
+        HD PackedView() : data(nullptr) {}
+        HD PackedView(uint64_t* memory, uint64_t capacity) : data(reinterpret_cast<T*>(memory)) {}
+
+        HD T operator[](uint64_t i) const { return data[i]; }
+        HD uint64_t word(int k, uint64_t i) const { return data[i].getWord(k); }
+        HD void set(uint64_t i, const T& cs) const { data[i] = cs; }
+
+        HD PackedView operator+(uint64_t offset) const { PackedView view; view.data = data + offset; return view; }
+        HD uint64_t* memory() const { return reinterpret_cast<uint64_t*>(data); }
+
+        T* data;
+    };
+
+    // The word k of all the CSs is contiguous, at words[k * stride + i]. An operation that needs only
+    // a few words of its operands, like the solution check, streams only those words
+    template <class T>
+    struct WordSlicedView {
+        HD WordSlicedView() : words(nullptr), stride(0) {}
+        HD WordSlicedView(uint64_t* memory, uint64_t capacity) : words(memory), stride(capacity) {}
+
+        HD T operator[](uint64_t i) const {
+            T cs;
+            for (int k = 0; k < T::wordCount; ++k) cs.setWord(k, words[k * stride + i]);
+            return cs;
+        }
+        HD uint64_t word(int k, uint64_t i) const { return words[k * stride + i]; }
+        HD void set(uint64_t i, const T& cs) const {
+            for (int k = 0; k < T::wordCount; ++k) words[k * stride + i] = cs.getWord(k);
+        }
+
+        HD WordSlicedView operator+(uint64_t offset) const { return WordSlicedView(words + offset, stride); }
+        HD uint64_t* memory() const { return words; }
+
+        uint64_t* words;
+        uint64_t stride;
+    };
+
+    // The language cache of the host, it grows with the enumeration
+    template <class T>
+    class PackedVector {
+    public:
+        size_t size() const { return data.size(); }
+        void resize(size_t n) { data.resize(n); }
+        void push_back(const T& cs) { data.push_back(cs); }
+
+        const T& operator[](size_t i) const { return data[i]; }
+        uint64_t word(int k, size_t i) const { return data[i].getWord(k); }
+
+        // Writing count CSs from the position first on, which is in the cache already
+        void write(size_t first, const T* css, size_t count) { std::copy_n(css, count, data.begin() + first); }
+
+        // Removing the n oldest CSs, once they are kept somewhere else
+        void eraseFront(size_t n) { data.erase(data.begin(), data.begin() + n); }
+
+        // Everything is in memory already
+        void prefetch(Pair<int>) const {}
+
+    private:
+        std::vector<T> data;
+    };
+
+    template <class T>
+    class WordSlicedVector {
+    public:
+        size_t size() const { return count; }
+        void resize(size_t n) {
+            for (auto& slice : slices) slice.resize(n);
+            count = n;
+        }
+        void push_back(const T& cs) {
+            for (int k = 0; k < T::wordCount; ++k) slices[k].push_back(cs.getWord(k));
+            count++;
+        }
+
+        T operator[](size_t i) const {
+            T cs;
+            for (int k = 0; k < T::wordCount; ++k) cs.setWord(k, slices[k][i]);
+            return cs;
+        }
+        uint64_t word(int k, size_t i) const { return slices[k][i]; }
+
+        void write(size_t first, const T* css, size_t n) {
+            for (int k = 0; k < T::wordCount; ++k) {
+                uint64_t* slice = slices[k].data() + first;
+                for (size_t i = 0; i < n; ++i) slice[i] = css[i].getWord(k);
+            }
+        }
+
+        void eraseFront(size_t n) {
+            for (auto& slice : slices) slice.erase(slice.begin(), slice.begin() + n);
+            count -= n;
+        }
+
+        void prefetch(Pair<int>) const {}
+
+    private:
+        std::vector<uint64_t> slices[T::wordCount];
+        size_t count = 0;
+    };
+
+    // Or and And, on CSs and on their single words
+    struct OrOp {
+        template <class T>
+        HD T operator()(const T& left, const T& right) const { return left | right; }
+    };
+
+    struct AndOp {
+        template <class T>
+        HD T operator()(const T& left, const T& right) const { return left & right; }
+    };
+
+    // The solution check of op(cache[ldx], cache[rdx]) on the words that have positive or negative
+    // examples only. The rest of the CS doesn't matter when it can't be stored anyway
+    template <class Cache, class T, class Op>
+    HD bool maybeSolution(const Cache& cache, uint64_t ldx, uint64_t rdx, const SolutionCheck<T>& solution, Op op)
+    {
+        return solution.check([&](int k) { return op(cache.word(k, ldx), cache.word(k, rdx)); });
+    }
+}
+
+#ifdef WORD_SLICED_CACHE
+using CacheView = paresy_s::WordSlicedView<CS>;
+using HostCacheLayout = paresy_s::WordSlicedVector<CS>;
+#else
+using CacheView = paresy_s::PackedView<CS>;
+using HostCacheLayout = paresy_s::PackedVector<CS>;
+#endif
+
+#endif // LANGUAGE_CACHE_H
@@ -0,0 +1,64 @@
+#ifndef MEET_IN_THE_MIDDLE_HPP
+#define MEET_IN_THE_MIDDLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+
+#include <pair.h>
+
+namespace paresy_s
+{
+    // The bits of a CS at the positions of the positive and the negative examples, packed into one word each.
+    // Only used when there are at most 64 of each
+    struct Projection {
+        uint64_t pos;
+        uint64_t neg;
+    };
+
+    template <class CS>
+    HD Projection projectCS(const CS& cs, const int* posIndices, int posCount, const int* negIndices, int negCount) {
+        Projection p = { 0, 0 };
+        for (int k = 0; k < posCount; ++k) if (cs.test(posIndices[k])) p.pos |= (uint64_t)1 << k;
+        for (int k = 0; k < negCount; ++k) if (cs.test(negIndices[k])) p.neg |= (uint64_t)1 << k;
+        return p;
+    }
+
+    // Index over the keys of a set of language cache entries, it finds an entry whose key covers a given mask.
+    // Narrow keys are answered from a superset table. Wide ones are sorted, which lays them out like the
+    // leaves of a bit-trie, and the search walks it from the highest bit down. A subtree is skipped once the
+    // OR of its keys misses a bit of the mask, the ORs of the ranges come from a segment tree
+    class ProjectionIndex {
+    public:
+        ProjectionIndex(int width);
+
+        void add(uint64_t key, int index);
+        void build();
+
+        // An entry whose key has all the bits of need, or -1
+        int findSuperset(uint64_t need) const;
+
+        static constexpr int maxTableWidth = 16;
+
+    private:
+        int search(uint64_t need, int lo, int hi, int bit) const;
+        uint64_t rangeOr(int lo, int hi) const;
+
+        int width;
+        std::vector<int> table;
+        std::unordered_map<uint64_t, int> keys;
+        std::vector<std::pair<uint64_t, int>> sortedKeys;
+        std::vector<uint64_t> orTree;
+    };
+
+    // Looking for A in [lstart, lend) and B in [rstart, rend) where A+B is a solution, both of them reject
+    // every negative and together they accept every positive. Returns their indices, or (-1, -1)
+    Pair<int> findAlternation(const Projection* projections, Pair<int> left, Pair<int> right, int posCount);
+
+    // Same for A&B, both of them accept every positive and no negative is accepted by the two
+    Pair<int> findIntersection(const Projection* projections, Pair<int> left, Pair<int> right, int posCount, int negCount);
+}
+
+#endif // MEET_IN_THE_MIDDLE_HPP
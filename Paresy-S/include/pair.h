@@ -1,7 +1,11 @@
 #ifndef PAIR_H
 #define PAIR_H
 
+#ifdef __CUDACC__
 #define HD __host__ __device__
+#else
+#define HD
+#endif
 
 namespace paresy_s {
 
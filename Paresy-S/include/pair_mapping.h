@@ -0,0 +1,28 @@
+#ifndef PAIR_MAPPING_H
+#define PAIR_MAPPING_H
+
+#include <cmath>
+#include <cstdint>
+
+#include <pair.h>
+
+namespace paresy_s {
+
+    // Number of the pairs x < y in an interval of n REs
+    HD inline uint64_t triangularCount(int n) {
+        return n > 1 ? (uint64_t)n * (n - 1) / 2 : 0;
+    }
+
+    // The pair (x, y), x < y, with the given number when the pairs of an interval are listed by y:
+    // (0, 1), (0, 2), (1, 2), (0, 3), ... For commutative operations it skips (y, x) and (x, x)
+    HD inline Pair<int> triangularIndex(uint64_t pair) {
+        auto y = static_cast<uint64_t>((1 + sqrt(1 + 8.0 * pair)) / 2);
+        // correcting the rounding of sqrt
+        while (y * (y - 1) / 2 > pair) y--;
+        while ((y + 1) * y / 2 <= pair) y++;
+        return { static_cast<int>(pair - y * (y - 1) / 2), static_cast<int>(y) };
+    }
+
+}
+
+#endif // PAIR_MAPPING_H
@@ -0,0 +1,119 @@
+#ifndef RE_STRING_HPP
+#define RE_STRING_HPP
+
+#include <string>
+#include <vector>
+#include <climits>
+#include <algorithm>
+
+#include <rei.h>
+#include <pair.h>
+#include <cost_intervals.h>
+#include <solution_set.hpp>
+
+namespace paresy_s
+{
+    // A single character or a character class
+    bool isAtom(const std::string& s);
+
+    // Adding parentheses if needed
+    std::string bracket(std::string s);
+
+    // The left and right indices of the REs that the solutions are made of, and only of those.
+    // They are kept in a flat vector sorted by the index of the RE
+    class Provenance {
+    public:
+        // The indices that stand for the solutions themselves, they are not in the language cache
+        static int rootIndex(int solution) { return INT_MAX - 1 - solution; }
+        static constexpr int finalIndex = INT_MAX - 1;
+
+        // Following the indices down from the left and right indices of every solution, one depth of them at a time.
+        // fetch(indices, left, right) gives the left and right indices of all the REs of a depth, so a language cache
+        // on the device is read in one go per depth, and only where the solutions need it
+        template <class Fetch>
+        Provenance(const std::vector<Pair<int>>& roots, int alphabetSize, Fetch fetch);
+
+        // From the whole arrays of the left and right indices
+        Provenance(const std::vector<Pair<int>>& roots, int alphabetSize, const int* leftIdx, const int* rightIdx)
+            : Provenance(roots, alphabetSize,
+                [&](const std::vector<int>& indices, std::vector<int>& left, std::vector<int>& right) {
+                    for (size_t i = 0; i < indices.size(); ++i) { left[i] = leftIdx[indices[i]]; right[i] = rightIdx[indices[i]]; }
+                }) {}
+
+        int left(int index) const { return find(index).left; }
+        int right(int index) const { return find(index).right; }
+
+        // The number of REs in the solutions that are not atoms, with the solutions themselves
+        size_t size() const { return nodes.size(); }
+
+    private:
+        struct Node {
+            int index, left, right;
+            bool operator<(const Node& other) const { return index < other.index; }
+        };
+
+        const Node& find(int index) const { return *std::lower_bound(nodes.begin(), nodes.end(), Node{ index, 0, 0 }); }
+
+        bool contains(int index) const {
+            auto it = std::lower_bound(nodes.begin(), nodes.end(), Node{ index, 0, 0 });
+            return it != nodes.end() && it->index == index;
+        }
+
+        std::vector<Node> nodes;
+    };
+
+    template <class Fetch>
+    Provenance::Provenance(const std::vector<Pair<int>>& roots, int alphabetSize, Fetch fetch)
+    {
+        for (size_t i = 0; i < roots.size(); ++i) nodes.push_back({ rootIndex(static_cast<int>(i)), roots[i].left, roots[i].right });
+        std::sort(nodes.begin(), nodes.end());
+
+        // The atoms and the character classes have nothing to follow
+        std::vector<int> depth, next, left, right;
+        auto follow = [&](int index) { if (index >= alphabetSize && !contains(index)) next.push_back(index); };
+        for (auto& root : roots) { follow(root.left); follow(root.right); }
+
+        while (!next.empty()) {
+            std::sort(next.begin(), next.end());
+            next.erase(std::unique(next.begin(), next.end()), next.end());
+            depth.swap(next);
+            next.clear();
+
+            left.resize(depth.size());
+            right.resize(depth.size());
+            fetch(depth, left, right);
+
+            for (size_t i = 0; i < depth.size(); ++i) nodes.push_back({ depth[i], left[i], right[i] });
+            std::sort(nodes.begin(), nodes.end());
+
+            for (size_t i = 0; i < depth.size(); ++i) { follow(left[i]); follow(right[i]); }
+        }
+    }
+
+    // Generating the final RE string recursively from the left and right indices of every RE in it
+    std::string toString(
+        int index,
+        const Provenance& provenance,
+        const std::vector<std::string>& atoms,
+        const std::vector<std::string>& classAtoms,
+        const CostIntervals& intervals);
+
+    // The string of the RE at index that op has made
+    std::string toString(
+        int index,
+        Opreation op,
+        const Provenance& provenance,
+        const std::vector<std::string>& atoms,
+        const std::vector<std::string>& classAtoms,
+        const CostIntervals& intervals);
+
+    // The strings of the collected solutions, from a provenance that has their roots in the same order
+    std::vector<Solution> toStrings(
+        const std::vector<FoundSolution>& found,
+        const Provenance& provenance,
+        const std::vector<std::string>& atoms,
+        const std::vector<std::string>& classAtoms,
+        const CostIntervals& intervals);
+}
+
+#endif // RE_STRING_HPP
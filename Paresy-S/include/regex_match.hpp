@@ -25,6 +25,14 @@ public:
      bool match(const string& word) const override;
 };
 
+// Character class, "[abc]" matches one of its characters
+class CharClass : public Regex {
+public:
+    string chars;
+     CharClass(const string& chars);
+     bool match(const string& word) const override;
+};
+
 class Or : public Regex {
 public:
     shared_ptr<Regex> left, right;
@@ -81,4 +89,11 @@ public:
 
  vector<bool> match(const vector<string>& examples, const string& pattern);
 
+ // Short-circuiting check, the examples are visited in the given order and it stops at the first one
+ // whose membership is different from expected. Returns the position of that example inside order, or -1.
+ // Large sets are checked in parallel chunks, which stop as soon as any chunk finds a violation. They run on a pool
+ // of the calling thread that is kept between the calls, with up to threads of them, 0 uses all the cores.
+ long firstViolation(const vector<string>& examples, const vector<int>& order, const string& pattern, bool expected, unsigned long long& matchCalls,
+     int threads = 0);
+
 #endif
\ No newline at end of file
@@ -1,25 +1,98 @@
 #ifndef REI_HPP
 #define REI_HPP
 
+#include <atomic>
 #include <string>
 #include <vector>
 
 namespace paresy_s
 {
 
+    struct Solution
+    {
+        std::string     RE;
+        int             REcost;
+    };
+
     struct Result
     {
         std::string     RE;
         int             REcost;
         unsigned long   allREs;
         int             ICsize;
+        // With SOLUTION_COUNT or SOLUTION_SLACK, all the solutions that have been collected. RE is the first of them
+        std::vector<Solution> solutions;
 
         Result(const std::string& RE, int REcost, unsigned long allREs, int ICsize)
             : RE(RE), REcost(REcost), allREs(allREs), ICsize(ICsize) {
         }
     };
 
-    Result REI(const unsigned short* costFun, const unsigned short maxCost, const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime);
+    // An RE that the enumeration starts from, it is stored like a character at the level of its cost.
+    // The cost is up to the caller, the RE doesn't have to be one the cost function would give it
+    struct Seed
+    {
+        std::string     RE;
+        int             cost;
+    };
+
+    // The seeds are evaluated over the examples and put into the language cache before the enumeration starts,
+    // so the solution can be made of them. They may tell apart characters that the examples can't,
+    // so ALPHABET_CLASSES doesn't compress the alphabet when there are any
+    Result REI(const unsigned short* costFun, const unsigned short maxCost, const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime,
+        const std::vector<Seed>& seeds = {});
+
+    // The part of the memory and of the threads that the enumerations of the calling thread take while it is alive.
+    // The DC drivers that run several leaves at once give each one an equal part instead of the whole budget:
+    // HOST_MEMORY, HOST_DISK and HOST_THREADS on the host, the free memory on the device. They nest on a thread,
+    // and a task that runs on another thread takes the parts of the thread that has submitted it as inherited
+    class ResourceShare {
+    public:
+        explicit ResourceShare(int parts);
+        ResourceShare(int inherited, int parts);
+        ~ResourceShare();
+
+        ResourceShare(const ResourceShare&) = delete;
+        ResourceShare& operator=(const ResourceShare&) = delete;
+
+        // The parts the budget of this thread is split into
+        static int parts();
+
+    private:
+        int previous;
+    };
+
+    // A flag that ends the enumerations of the calling thread while it is alive, at the next point where they check
+    // the time, as if the time were up. speculativeLeaf sets it for the samples that can't win anymore
+    class StopScope {
+    public:
+        explicit StopScope(const std::atomic<bool>& stop);
+        ~StopScope();
+
+        StopScope(const StopScope&) = delete;
+        StopScope& operator=(const StopScope&) = delete;
+
+        // The flag of this thread has been set
+        static bool stopped();
+
+    private:
+        const std::atomic<bool>* previous;
+    };
+
+    struct HostExamples;
+
+    // The inference over an infix-closure and a guide table that are made already, like the projections
+    // of the one of a whole DC run onto its windows. pos and neg are the words that examples is made of.
+    // The host enumeration keeps snapshots in CHECKPOINT_DIR only when checkpoint is set, the other overloads always do
+    Result REI(const HostExamples& examples, const unsigned short* costFun, const unsigned short maxCost,
+        const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime, const std::vector<Seed>& seeds = {},
+        bool checkpoint = false);
+
+    // The inference of the same examples under several cost functions, a result for each one in their order.
+    // The infix-closure and the guide table are made once, and a cost function that is a multiple of an earlier one
+    // gets its solution with the costs scaled instead of another enumeration
+    std::vector<Result> REI(const std::vector<const unsigned short*>& costFuns, const unsigned short maxCost,
+        const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime);
 }
 
 #endif // REI_HPP
\ No newline at end of file
@@ -4,6 +4,11 @@
 #include <vector>
 #include <string>
 #include <tuple>
+#include <future>
+#include <functional>
+
+#include <rei.h>
+#include <ic_projection.hpp>
 
 namespace paresy_s {
 
@@ -12,6 +17,9 @@ namespace paresy_s {
         int callCount = 0;
         int currentDepth = 0;
         int maxDepth = 0;
+        // match calls done by the consistency checks, and the ones a full evaluation of every example would need
+        unsigned long long matchCalls = 0;
+        unsigned long long exhaustiveMatchCalls = 0;
 
         void enter() {
             ++callCount;
@@ -25,11 +33,74 @@ namespace paresy_s {
         }
     };
 
+    // Short-circuiting consistency checks over one set of examples of a sub-problem.
+    // The example that caused the last failure is moved to the front, so it's tried first by the next check.
+    // A check can be limited to a part of the set, so the checks of a sub-problem on the parts of its
+    // positives or negatives share one checker and its order
+    class ConsistencyChecker
+    {
+    public:
+        ConsistencyChecker(const std::vector<std::string>& examples, RecursiveProfileInfo& profileInfo);
+
+        bool acceptsAll(const std::string& pattern) { return check(pattern, true, nullptr); }
+        bool rejectsAll(const std::string& pattern) { return check(pattern, false, nullptr); }
+
+        // Only the examples i with within[i] are checked
+        bool acceptsAll(const std::string& pattern, const std::vector<bool>& within) { return check(pattern, true, &within); }
+        bool rejectsAll(const std::string& pattern, const std::vector<bool>& within) { return check(pattern, false, &within); }
+
+    private:
+        bool check(const std::string& pattern, bool expected, const std::vector<bool>* within);
+
+        const std::vector<std::string>& examples;
+        std::vector<int> order;
+        RecursiveProfileInfo& profileInfo;
+    };
+
+    // The solver of the sub-problems that fit in a window. examples is the infix-closure of pos and neg,
+    // projected from the one of the whole DC run. With SPECULATIVE_SAMPLES it is called from several threads at once.
+    // checkpoint is only set when the sub-problem is the whole run, the snapshots of the others would never be resumed
+    using LeafSolver = std::function<Result(const HostExamples& examples, const unsigned short* costFun, const unsigned short maxCost,
+        const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime, const std::vector<Seed>& seeds, bool checkpoint)>;
+
+    // REI, the default one
+    Result reiSolver(const HostExamples& examples, const unsigned short* costFun, const unsigned short maxCost,
+        const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime, const std::vector<Seed>& seeds, bool checkpoint);
+
+    // The enumeration on the host, it stands in for REI on a machine without a GPU
+    Result hostSolver(const HostExamples& examples, const unsigned short* costFun, const unsigned short maxCost,
+        const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime, const std::vector<Seed>& seeds, bool checkpoint);
+
+    // The infix-closure of pos and neg is made once, the windows get their part of it
     std::string detSplit(int window, const unsigned short* costFun, const unsigned short maxCost,
-        const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime, RecursiveProfileInfo& profileInfo);
+        const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime, RecursiveProfileInfo& profileInfo,
+        const LeafSolver& solver = reiSolver);
 
     std::string randSplit(int window, const unsigned short* costFun, const unsigned short maxCost,
-        const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime, RecursiveProfileInfo& profileInfo);
+        const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime, RecursiveProfileInfo& profileInfo,
+        const LeafSolver& solver = reiSolver);
+
+    // Bottom-up: the examples are dealt round-robin into leaves of about window of them, each with positives and
+    // negatives, the leaves are solved in parallel and merged pairwise up a tree, the pairs of a level in parallel.
+    // A merge tells the membership of its REs from the ones of the pool that every solved RE is matched against once,
+    // and patches them like detSplit. 0 threads uses all the cores
+    std::string mergeSplit(int window, const unsigned short* costFun, const unsigned short maxCost,
+        const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime, RecursiveProfileInfo& profileInfo,
+        const LeafSolver& solver = reiSolver, int threads = 0);
+
+    // Updating an RE that is consistent with pos and neg to the new examples. It is parsed once and only the new
+    // examples are checked. The negatives that it accepts are patched with an intersection, and the positives that
+    // it rejects with an alternation. Each patch is solved by randSplit on the new examples that decide it, the old
+    // ones are only checked, and the ones that it gets wrong are added to the examples of another solve
+    std::string repairRE(const std::string& previous, int window, const unsigned short* costFun, const unsigned short maxCost,
+        const std::vector<std::string>& pos, const std::vector<std::string>& neg,
+        const std::vector<std::string>& newPos, const std::vector<std::string>& newNeg, double maxTime, RecursiveProfileInfo& profileInfo,
+        const LeafSolver& solver = reiSolver);
+
+    // The patches pile up over the updates, this infers the RE of all the examples again on another thread.
+    // It takes the memory of a full run, so it shouldn't overlap with another inference on the same device
+    std::future<std::string> reoptimizeInBackground(int window, const unsigned short* costFun, const unsigned short maxCost,
+        std::vector<std::string> pos, std::vector<std::string> neg, double maxTime, const LeafSolver& solver = reiSolver);
 }
 
 #endif //REI_DC
\ No newline at end of file
@@ -0,0 +1,175 @@
+#ifndef REI_HOST_HPP
+#define REI_HOST_HPP
+
+#include <set>
+#include <bitset>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_set>
+
+#include <rei.h>
+#include <pair.h>
+#include <cs.h>
+#include <cost_intervals.h>
+#include <solution_set.hpp>
+#include <tiered_cache.hpp>
+#include <rei_util.hpp>
+#include <alphabet_classes.hpp>
+
+namespace paresy_s
+{
+    // A subset of the words of an infix-closure, a bit for every word. The rank of a word is its index in the subset
+    class WordSelection {
+    public:
+        explicit WordSelection(int size) : bits((size + 63) / 64, 0), prefix(bits.size() + 1, 0) {}
+
+        void set(int ix) { bits[ix / 64] |= (uint64_t)1 << (ix % 64); }
+        void reset(int ix) { bits[ix / 64] &= ~((uint64_t)1 << (ix % 64)); }
+        bool test(int ix) const { return (bits[ix / 64] >> (ix % 64)) & 1; }
+        // The blocks of 64 words, the empty ones are skipped at once
+        uint64_t block(int ix) const { return bits[ix / 64]; }
+
+        // Counting the words in front of every block, once all of them are set
+        void seal() {
+            for (size_t i = 0; i < bits.size(); ++i) prefix[i + 1] = prefix[i] + static_cast<int>(std::bitset<64>(bits[i]).count());
+        }
+
+        int rank(int ix) const {
+            uint64_t below = bits[ix / 64] & (((uint64_t)1 << (ix % 64)) - 1);
+            return prefix[ix / 64] + static_cast<int>(std::bitset<64>(below).count());
+        }
+
+        int count() const { return prefix.back(); }
+
+    private:
+        std::vector<uint64_t> bits;
+        std::vector<int> prefix;
+    };
+
+    // The guide table of the host enumeration. Instead of a pair of one-hot CSs,
+    // every split of a word into two shorter words is kept as their indices in the infix-closure
+    class HostGuideTable {
+    public:
+        HostGuideTable() = default;
+        HostGuideTable(const std::set<std::string, strComparison>& ic);
+
+        // The guide table of a sealed selection of the words, which holds the infixes of every word in it.
+        // The rows of its words are kept, with the ranks of the words as their indices
+        HostGuideTable project(const WordSelection& selection) const;
+
+        // Splits of the word ix are in [rowStart[ix], rowStart[ix + 1])
+        const Pair<int>* rowBegin(int ix) const { return splits.data() + rowStart[ix]; }
+        const Pair<int>* rowEnd(int ix) const { return splits.data() + rowStart[ix + 1]; }
+
+        int ICsize = 0;
+        int alphabetSize = 0;
+
+    private:
+        std::vector<int> rowStart;
+        std::vector<Pair<int>> splits;
+    };
+
+    CS hostQuestion(const CS& cs);
+    CS hostStar(const HostGuideTable& guideTable, const CS& cs);
+    CS hostConcatenate(const HostGuideTable& guideTable, const CS& left, const CS& right);
+
+#if HOST_DISK > 0
+    // With a spill file only the 128 bit hash of every visited CS stays in memory, like on the device
+    struct VisitedKey {
+        VisitedKey(const CS& cs) { auto [h, l] = cs.get128Hash(); high = h; low = l; }
+        bool operator==(const VisitedKey& other) const { return high == other.high && low == other.low; }
+        uint64_t high, low;
+    };
+
+    struct VisitedKeyHash {
+        size_t operator()(const VisitedKey& key) const { return std::hash<uint64_t>{}(key.low) ^ (std::hash<uint64_t>{}(key.high) << 1); }
+    };
+
+    using VisitedSet = std::unordered_set<VisitedKey, VisitedKeyHash>;
+#else
+    using VisitedSet = std::unordered_set<CS>;
+#endif
+
+    // The language cache of the host enumeration, laid out as the one on the device:
+    // the CSs in the order of their cost, and the indices of the left and right sub-REs of each
+    class HostContext {
+    public:
+        HostContext(uint64_t capacity, CS posBits, CS negBits);
+
+        // How many REs can be stored in the given amount of memory
+        static uint64_t getCacheCapacity(uint64_t memorySize);
+
+        // How many REs can be stored with a spill file of diskSize bytes, and how many of them stay in memory
+        static Pair<uint64_t> getTieredCapacity(uint64_t memorySize, uint64_t diskSize);
+
+        bool isSolution(const CS& cs) const { return solution(cs); }
+
+        // Checking a new RE, it is stored when it is unique and there is still space.
+        // Returns true when it is a solution, which is kept aside for the string
+        bool insert(const CS& cs, int ldx, int rdx);
+
+        // The check of insert without storing the RE. Returns the position in the language cache that is
+        // reserved for it, or -1 when it is not stored. The caller stores it before the cache is read again
+        int64_t reserve(const CS& cs, int ldx, int rdx);
+
+        // Checking empty, epsilon, and the alphabet
+        bool intialCheck(const std::vector<std::string>& pos, const std::vector<std::string>& neg,
+            const AlphabetClasses& classes, std::string& RE);
+
+        std::string REtoString(const CostIntervals& intervals) const;
+
+        // The strings of all the collected solutions at once
+        std::vector<Solution> solutionStrings(const CostIntervals& intervals) const;
+
+        std::set<char> alphabet;
+        std::vector<std::string> atoms;
+        std::vector<std::string> classAtoms;
+
+        HostLanguageCache langCache;
+        std::vector<int> leftIdx;
+        std::vector<int> rightIdx;
+        VisitedSet visited;
+
+        uint64_t capacity;
+        uint64_t allREs;
+        // Index of the last free position in the language cache
+        uint64_t lastIdx;
+        bool isFound;
+        bool onTheFly;
+        // The left and right indices of the solution
+        int finalLeftIdx, finalRightIdx;
+        // When SOLUTION_COUNT or SOLUTION_SLACK is set, the solutions go here instead, with the cost and the operation
+        // of the REs that are checked when they are found. isFound is set once it is full then
+        SolutionSet solutions;
+        int checkedCost;
+        Opreation checkedOp;
+        CS posBits, negBits;
+        SolutionCheck<CS> solution;
+    };
+
+    // The infix-closure of the examples as the host enumeration uses it. It doesn't depend on the cost function,
+    // so the runs of a batch share it
+    struct HostExamples {
+        HostExamples(const std::vector<std::string>& pos, const std::vector<std::string>& neg);
+
+        // An infix-closure that is made already
+        HostExamples(HostGuideTable guideTable, CS posBits, CS negBits);
+
+        // The infix-closure fits in a CS
+        bool fits;
+        HostGuideTable guideTable;
+        CS posBits, negBits;
+    };
+
+    Result hostEnumerate(const HostExamples& examples, const unsigned short* costFun, const unsigned short maxCost,
+        const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime, const AlphabetClasses& classes,
+        const std::vector<Seed>& seeds = {}, bool checkpoint = false);
+
+    // The enumeration of PaRESy on the host, it gives the same results as the device one
+    // and can be used to verify it on machines without a GPU. With checkpoint, it keeps snapshots in CHECKPOINT_DIR
+    Result hostEnumerate(const unsigned short* costFun, const unsigned short maxCost, const std::vector<std::string>& pos, const std::vector<std::string>& neg,
+        double maxTime, const AlphabetClasses& classes, const std::vector<Seed>& seeds = {}, bool checkpoint = false);
+}
+
+#endif // REI_HOST_HPP
@@ -1,19 +1,114 @@
 #ifndef REI_UTIL_HPP
 #define REI_UTIL_HPP
 
+#include <set>
+#include <string>
 #include <vector>
+#include <chrono>
+#include <memory>
 #include <sstream>
 #include <iostream>
+#include <string_view>
 
 //#include "rei.h"
 
 namespace paresy_s
 {
+	// Shortlex ordering
+	struct strComparison {
+		bool operator () (const std::string& str1, const std::string& str2) const {
+			if (str1.length() == str2.length()) return str1 < str2;
+			return str1.length() < str2.length();
+		}
+	};
+
+	// Generating the infix of a string
+	std::set<std::string, strComparison> infixesOf(const std::string& word);
+
+	// Generating infix-closure (ic) of the input strings
+	std::set<std::string, strComparison> generatingIC(const std::vector<std::string>& pos, const std::vector<std::string>& neg);
+
+	// Whether maxTime seconds have passed since startTime, or the enumeration has been stopped by a StopScope
+	bool checkTime(std::chrono::steady_clock::time_point startTime, double maxTime);
+
 	bool readStream(std::istream& stream, std::vector<std::string>& pos, std::vector<std::string>& neg);
 
 	// Reading the input file
 	bool readFile(const std::string& fileName, std::vector<std::string>& pos, std::vector<std::string>& neg);
 
+	// Read-only memory mapping of a whole file
+	class MappedFile {
+	public:
+		MappedFile(const std::string& fileName);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool isOpen() const { return opened; }
+		const char* data() const { return data_; }
+		size_t size() const { return size_; }
+
+	private:
+		const char* data_ = nullptr;
+		size_t size_ = 0;
+		bool opened = false;
+#ifdef _WIN32
+		void* fileHandle = nullptr;
+		void* mappingHandle = nullptr;
+#endif
+	};
+
+	// Writable memory mapping of a new temporary file, which is removed when it is closed.
+	// Its pages are written back by the OS, so only the parts that are in use stay in memory
+	class SpillFile {
+	public:
+		SpillFile(size_t size);
+		~SpillFile();
+
+		SpillFile(const SpillFile&) = delete;
+		SpillFile& operator=(const SpillFile&) = delete;
+
+		bool isOpen() const { return data_ != nullptr; }
+		char* data() const { return data_; }
+		size_t size() const { return size_; }
+
+		// Asking the OS to read a range of the file before it is used
+		void prefetch(size_t offset, size_t length) const;
+
+	private:
+		char* data_ = nullptr;
+		size_t size_ = 0;
+#ifdef _WIN32
+		void* fileHandle = nullptr;
+		void* mappingHandle = nullptr;
+#endif
+	};
+
+	// Examples parsed in place from a mapped file. The words are views into the mapping,
+	// or into the pools when quotes or spaces had to be removed from the middle of a word.
+	class ExampleSet {
+	public:
+		std::vector<std::string_view> pos, neg;
+		// line number of each word inside the file, starting from 1
+		std::vector<size_t> posLines, negLines;
+
+		void toVectors(std::vector<std::string>& pos, std::vector<std::string>& neg) const;
+
+	private:
+		friend bool readMappedFile(const std::string& fileName, ExampleSet& examples, unsigned int threadCount);
+
+		std::unique_ptr<MappedFile> file;
+		std::vector<std::unique_ptr<char[]>> pools;
+	};
+
+	// Reading the input file through a memory mapping, large files are parsed in parallel chunks.
+	// Duplicated words are removed, a word in both Pos and Neg is reported with its line numbers.
+	// A threadCount of 0 uses the hardware concurrency
+	bool readMappedFile(const std::string& fileName, ExampleSet& examples, unsigned int threadCount = 0);
+
+	bool readMappedFile(const std::string& fileName, std::vector<std::string>& pos, std::vector<std::string>& neg);
+
 	class OperationsCount {
 	public:
 		int alpha = 0;
@@ -22,6 +117,7 @@ namespace paresy_s
 		int concat = 0;
 		int alternation = 0;
 		int intersection = 0;
+		int charClass = 0;
 
 		OperationsCount() = default;
 	};
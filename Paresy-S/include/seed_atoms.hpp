@@ -0,0 +1,43 @@
+#ifndef SEED_ATOMS_HPP
+#define SEED_ATOMS_HPP
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <rei.h>
+#include <pair.h>
+#include <cs.h>
+#include <cost_intervals.h>
+#include <rei_host.hpp>
+
+namespace paresy_s
+{
+    // The CS of an RE over the infix-closure. Its syntax tree is evaluated bottom-up with the operations
+    // of the guide table, the characters that are not in the alphabet match no word
+    CS seedCS(const std::string& RE, const HostGuideTable& guideTable, const std::set<char>& alphabet);
+
+    // The REs that the enumeration doesn't make itself: the character classes and the seeds. Each one is stored
+    // like a result of concatenation at the level of its cost, with -3 - i as its left and right index, where i is
+    // the position of its string. They are sorted by their cost, so the ones of a level are an interval
+    class ExtraAtoms {
+    public:
+        // The classes of CHAR_CLASS_COST and the seeds over the alphabet of the examples. A seed can't be cheaper
+        // than a single character, and the ones above maxCost or that don't parse are left out
+        ExtraAtoms(const Costs& costs, int maxCost, const std::vector<std::string>& pos, const std::vector<std::string>& neg,
+            const std::set<char>& alphabet, const std::vector<Seed>& seeds);
+
+        // The atoms of the level cost
+        Pair<int> level(int cost) const;
+
+        bool empty() const { return css.empty(); }
+
+        std::vector<std::string> strings;
+        std::vector<CS> css;
+
+    private:
+        std::vector<int> costs;
+    };
+}
+
+#endif // SEED_ATOMS_HPP
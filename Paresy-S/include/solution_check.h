@@ -0,0 +1,79 @@
+#ifndef SOLUTION_CHECK_H
+#define SOLUTION_CHECK_H
+
+#include <cstdint>
+
+#include <cs.h>
+
+namespace paresy_s
+{
+    // The check (cs & posBits) == posBits && (~cs & negBits) == negBits on the words that have examples only.
+    // The words that reject the most candidates come first, so most of the candidates are rejected by the first word
+    template <class T>
+    class SolutionCheck {
+    public:
+        HD SolutionCheck() : count(0) {}
+
+        SolutionCheck(const T& posBits, const T& negBits) : count(0) {
+            for (int k = 0; k < T::wordCount; ++k) {
+                uint64_t pos = posBits.getWord(k), neg = negBits.getWord(k);
+                if (!(pos | neg)) continue;
+                words[count] = static_cast<unsigned short>(k);
+                posMasks[count] = pos;
+                negMasks[count] = neg;
+                count++;
+            }
+
+            // A candidate is rejected by a positive example that it doesn't accept, or a negative one that it does.
+            // The languages of most REs are small, so the positives reject far more often than the negatives,
+            // then the longer words, which are less likely to be accepted
+            for (int i = 1; i < count; ++i)
+                for (int j = i; j > 0 && before(j, j - 1); --j) swap(j, j - 1);
+        }
+
+        HD bool operator()(const T& cs) const {
+            return check([&](int k) { return cs.getWord(k); });
+        }
+
+        // word(k) gives the word k of the candidate, only the words with examples are asked for
+        template <class Word>
+        HD bool check(Word word) const {
+            for (int i = 0; i < count; ++i) {
+                uint64_t w = word(words[i]);
+                if ((w & posMasks[i]) != posMasks[i] || (~w & negMasks[i]) != negMasks[i]) return false;
+            }
+            return true;
+        }
+
+        // The number of words that have examples
+        HD int size() const { return count; }
+
+    private:
+        static int bitCount(uint64_t x) {
+            int n = 0;
+            for (; x; x &= x - 1) n++;
+            return n;
+        }
+
+        bool before(int i, int j) const {
+            int iPos = bitCount(posMasks[i]), jPos = bitCount(posMasks[j]);
+            if (iPos != jPos) return iPos > jPos;
+            int iNeg = bitCount(negMasks[i]), jNeg = bitCount(negMasks[j]);
+            if (iNeg != jNeg) return iNeg > jNeg;
+            return words[i] > words[j];
+        }
+
+        void swap(int i, int j) {
+            unsigned short w = words[i]; words[i] = words[j]; words[j] = w;
+            uint64_t p = posMasks[i]; posMasks[i] = posMasks[j]; posMasks[j] = p;
+            uint64_t n = negMasks[i]; negMasks[i] = negMasks[j]; negMasks[j] = n;
+        }
+
+        int count;
+        unsigned short words[T::wordCount];
+        uint64_t posMasks[T::wordCount];
+        uint64_t negMasks[T::wordCount];
+    };
+}
+
+#endif // SOLUTION_CHECK_H
@@ -0,0 +1,61 @@
+#ifndef SOLUTION_SET_HPP
+#define SOLUTION_SET_HPP
+
+#include <set>
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+#include <cost_intervals.h>
+
+#ifndef SOLUTION_COUNT
+#define SOLUTION_COUNT 1
+#endif
+
+#ifndef SOLUTION_SLACK
+#define SOLUTION_SLACK 0
+#endif
+
+namespace paresy_s
+{
+    // A solution that is kept aside until the end: the indices of its left and right sub-REs,
+    // and the cost and the operation that have made it
+    struct FoundSolution {
+        int left, right;
+        int cost;
+        Opreation op;
+    };
+
+    // The solutions that an enumeration collects. By default it stops at the first one. With SOLUTION_COUNT = k
+    // it goes on to collect up to k distinct ones of the minimal cost, and with SOLUTION_SLACK = d also the ones
+    // of the levels up to the minimal cost + d, still at most k. The solutions are stored in the language cache
+    // like the other REs meanwhile, so the more expensive ones can be made of them
+    class SolutionSet {
+    public:
+        static constexpr int capacity = SOLUTION_COUNT;
+        static constexpr int slack = SOLUTION_SLACK;
+        // The enumeration goes on after the first solution
+        static constexpr bool collecting = capacity > 1 || slack > 0;
+
+        // Adding a solution unless its CS, known by its 128 bit hash, is in already. Returns true once it is full
+        bool add(uint64_t high, uint64_t low, const FoundSolution& solution) {
+            if (!full() && keys.insert({ high, low }).second) solutions.push_back(solution);
+            return full();
+        }
+
+        bool full() const { return static_cast<int>(solutions.size()) >= capacity; }
+        bool empty() const { return solutions.empty(); }
+
+        // Nothing is left to collect once the level cost is sealed. The levels are sealed in order,
+        // so the first solution has the minimal cost
+        bool done(int cost) const { return full() || (!empty() && cost >= solutions.front().cost + slack); }
+
+        const std::vector<FoundSolution>& all() const { return solutions; }
+
+    private:
+        std::vector<FoundSolution> solutions;
+        std::set<std::pair<uint64_t, uint64_t>> keys;
+    };
+}
+
+#endif // SOLUTION_SET_HPP
@@ -0,0 +1,92 @@
+#ifndef TIERED_CACHE_HPP
+#define TIERED_CACHE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <algorithm>
+
+#include <cs.h>
+#include <pair.h>
+#include <rei_util.hpp>
+#include <language_cache.h>
+
+#ifndef HOST_DISK
+#define HOST_DISK 0
+#endif
+
+namespace paresy_s
+{
+    // The language cache of the host with a second tier on disk. The newest REs stay in memory, up to hotCapacity
+    // of them. Past that, the oldest half is appended to a spill file, one CS after another in the order of the
+    // cache, and read back through its mapping. So the cache can grow until the file is full before switching
+    // to "OnTheFly", and the levels that are not read anymore leave the memory to the OS
+    template <class Hot>
+    class TieredLanguageCache {
+    public:
+        // Creating the spill file before anything is stored. Returns false when it can't be created,
+        // then the whole cache stays in memory
+        bool open(uint64_t hotCapacity, uint64_t spillCapacity) {
+            file = std::make_unique<SpillFile>(spillCapacity * sizeof(CS));
+            if (!file->isOpen()) return false;
+            this->hotCapacity = hotCapacity;
+            this->spillCapacity = spillCapacity;
+            return true;
+        }
+
+        size_t size() const { return spilled + hot.size(); }
+
+        // The positions that are in the cache already are written, the new ones are written after the call
+        void resize(size_t n) {
+            if (n - spilled > hotCapacity && spilled < spillCapacity) {
+                size_t count = std::min({ n - spilled - hotCapacity / 2, hot.size(), static_cast<size_t>(spillCapacity - spilled) });
+                spill(count);
+            }
+            hot.resize(n - spilled);
+        }
+
+        void push_back(const CS& cs) {
+            resize(size() + 1);
+            write(size() - 1, &cs, 1);
+        }
+
+        CS operator[](size_t i) const { return i < spilled ? spilledCSs()[i] : hot[i - spilled]; }
+        uint64_t word(int k, size_t i) const { return i < spilled ? spilledCSs()[i].getWord(k) : hot.word(k, i - spilled); }
+
+        // Only the REs in memory are written, the spilled ones are never changed
+        void write(size_t first, const CS* css, size_t count) { hot.write(first - spilled, css, count); }
+
+        // Reading the operands of a tile ahead from the spill file
+        void prefetch(Pair<int> interval) const {
+            if (static_cast<size_t>(interval.left) >= spilled) return;
+            size_t last = std::min(static_cast<size_t>(interval.right), spilled);
+            file->prefetch(interval.left * sizeof(CS), (last - interval.left) * sizeof(CS));
+        }
+
+        size_t spilledCount() const { return spilled; }
+
+    private:
+        const CS* spilledCSs() const { return reinterpret_cast<const CS*>(file->data()); }
+
+        // Appending the count oldest REs in memory to the spill file
+        void spill(size_t count) {
+            CS* out = reinterpret_cast<CS*>(file->data()) + spilled;
+            for (size_t i = 0; i < count; ++i) out[i] = hot[i];
+            hot.eraseFront(count);
+            spilled += count;
+        }
+
+        Hot hot;
+        std::unique_ptr<SpillFile> file;
+        size_t spilled = 0;
+        uint64_t hotCapacity = UINT64_MAX;
+        uint64_t spillCapacity = 0;
+    };
+}
+
+#if HOST_DISK > 0
+using HostLanguageCache = paresy_s::TieredLanguageCache<HostCacheLayout>;
+#else
+using HostLanguageCache = HostCacheLayout;
+#endif
+
+#endif // TIERED_CACHE_HPP
@@ -0,0 +1,72 @@
+#ifndef TILE_SCHEDULER_H
+#define TILE_SCHEDULER_H
+
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+#include <pair.h>
+
+namespace paresy_s {
+
+    // A block of the cross product of two intervals
+    struct Tile {
+        Pair<int> left;
+        Pair<int> right;
+
+        int size() const { return (left.right - left.left) * (right.right - right.left); }
+    };
+
+    // Partitioning the cross product of two intervals into 2D tiles of at most maxPairs pairs.
+    // The tiles are as square as the intervals allow, so the operands of a tile are only a few
+    // blocks of the language cache that stay in the cache of the worker, whatever the sizes of the
+    // intervals are. The tiles go row by row, consecutive tiles share their left block
+    class TileScheduler {
+    public:
+        TileScheduler(Pair<int> left, Pair<int> right, uint64_t maxPairs)
+            : left(left), right(right)
+        {
+            int leftSize = left.right - left.left;
+            int rightSize = right.right - right.left;
+            int side = std::max(1, static_cast<int>(std::sqrt(static_cast<double>(maxPairs))));
+
+            // a side that is shorter than the square gives the rest to the other one
+            tileLeft = std::max(1, std::min(leftSize, side));
+            tileRight = std::max(1, std::min<int>(rightSize, std::min<uint64_t>(INT32_MAX, maxPairs / tileLeft)));
+            if (tileRight == rightSize) tileLeft = std::max(1, std::min<int>(leftSize, std::min<uint64_t>(INT32_MAX, maxPairs / tileRight)));
+
+            leftTiles = leftSize > 0 ? (leftSize + tileLeft - 1) / tileLeft : 0;
+            rightTiles = rightSize > 0 ? (rightSize + tileRight - 1) / tileRight : 0;
+        }
+
+        int count() const { return leftTiles * rightTiles; }
+
+        Tile operator[](int i) const {
+            int l = left.left + (i / rightTiles) * tileLeft;
+            int r = right.left + (i % rightTiles) * tileRight;
+            return { { l, std::min(l + tileLeft, left.right) }, { r, std::min(r + tileRight, right.right) } };
+        }
+
+        class Iterator {
+        public:
+            Iterator(const TileScheduler& scheduler, int i) : scheduler(scheduler), i(i) {}
+            Tile operator*() const { return scheduler[i]; }
+            Iterator& operator++() { ++i; return *this; }
+            bool operator!=(const Iterator& other) const { return i != other.i; }
+        private:
+            const TileScheduler& scheduler;
+            int i;
+        };
+
+        Iterator begin() const { return Iterator(*this, 0); }
+        Iterator end() const { return Iterator(*this, count()); }
+
+    private:
+        Pair<int> left, right;
+        int tileLeft, tileRight;
+        int leftTiles, rightTiles;
+    };
+
+}
+
+#endif // TILE_SCHEDULER_H
@@ -0,0 +1,51 @@
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+namespace paresy_s
+{
+    // A fixed set of threads that run the units of a task. The units are pulled one by one from a shared
+    // counter, so a thread that got small units takes the next ones and skewed units don't leave cores idle.
+    // The calling thread works on the units too
+    class WorkerPool {
+    public:
+        // 0 threads uses all the cores
+        explicit WorkerPool(int threads);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        // The number of threads including the calling one
+        int size() const { return static_cast<int>(workers.size()) + 1; }
+
+        // Calls task(i) for every i in [0, count), it returns when all of them are done
+        void run(int count, const std::function<void(int)>& task);
+
+    private:
+        void work();
+        void pull();
+
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+
+        const std::function<void(int)>* task = nullptr;
+        int count = 0;
+        std::atomic<int> next{ 0 };
+        // Workers that have not finished the current task
+        int busy = 0;
+        uint64_t generation = 0;
+        bool stop = false;
+    };
+}
+
+#endif // WORKER_POOL_HPP
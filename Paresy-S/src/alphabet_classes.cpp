@@ -0,0 +1,110 @@
+#include <alphabet_classes.hpp>
+
+#include <algorithm>
+#include <set>
+#include <unordered_set>
+
+paresy_s::AlphabetClasses::AlphabetClasses() {
+    for (int i = 0; i < 256; ++i) representatives[i] = static_cast<char>(i);
+}
+
+paresy_s::AlphabetClasses::AlphabetClasses(const std::vector<std::string>& pos, const std::vector<std::string>& neg)
+    : AlphabetClasses() {
+
+    std::set<char> alphabet;
+    for (auto& word : pos) for (auto ch : word) alphabet.insert(ch);
+    for (auto& word : neg) for (auto ch : word) alphabet.insert(ch);
+
+    std::unordered_set<std::string> posSet(pos.begin(), pos.end()), negSet(neg.begin(), neg.end());
+
+    // The smallest character of a class is its representative, like that the order of the classes
+    // follows the order of the alphabet. Swap-invariance is transitive, so comparing with the
+    // representative is enough
+    std::vector<char> reps;
+    for (auto ch : alphabet) {
+        bool joined = false;
+        for (auto rep : reps) {
+            if (isSwapInvariant(rep, ch, pos, posSet) && isSwapInvariant(rep, ch, neg, negSet)) {
+                representatives[static_cast<unsigned char>(ch)] = rep;
+                isMerged = joined = true;
+                break;
+            }
+        }
+        if (!joined) reps.push_back(ch);
+    }
+
+    if (isMerged && !isConsistent(pos, neg)) {
+        for (int i = 0; i < 256; ++i) representatives[i] = static_cast<char>(i);
+        isMerged = false;
+    }
+
+    for (auto ch : alphabet) members[representative(ch)].push_back(ch);
+}
+
+std::string paresy_s::AlphabetClasses::expand(char representative) const {
+    auto it = members.find(representative);
+    if (it == members.end() || it->second.size() == 1) return std::string(1, representative);
+
+    std::string res = "(";
+    for (auto ch : it->second) {
+        if (res.size() > 1) res += '+';
+        res += ch;
+    }
+    return res + ")";
+}
+
+paresy_s::Result paresy_s::AlphabetClasses::expandCost(Result result, const unsigned short* costFun) const {
+    result.REcost += expansionCost(result.RE, costFun);
+    for (auto& solution : result.solutions) solution.REcost += expansionCost(solution.RE, costFun);
+    return result;
+}
+
+int paresy_s::AlphabetClasses::expansionCost(const std::string& RE, const unsigned short* costFun) const {
+    // The members other than the representative only show up in the expansions, each of them once, so
+    // counting one of them counts the expansions whatever brackets the output has been given
+    int res = 0;
+    for (auto& [rep, chars] : members) {
+        if (chars.size() == 1) continue;
+        auto other = chars[0] == rep ? chars[1] : chars[0];
+        auto expansions = static_cast<int>(std::count(RE.begin(), RE.end(), other));
+        res += expansions * static_cast<int>(chars.size() - 1) * (costFun[0] + costFun[4]);
+    }
+    return res;
+}
+
+std::string paresy_s::AlphabetClasses::project(const std::string& word) const {
+    std::string res(word);
+    for (auto& ch : res) ch = representative(ch);
+    return res;
+}
+
+std::vector<std::string> paresy_s::AlphabetClasses::project(const std::vector<std::string>& words) const {
+    std::vector<std::string> res;
+    std::unordered_set<std::string> seen;
+    for (auto& word : words) {
+        auto projected = project(word);
+        if (seen.insert(projected).second) res.push_back(std::move(projected));
+    }
+    return res;
+}
+
+bool paresy_s::AlphabetClasses::isConsistent(const std::vector<std::string>& pos, const std::vector<std::string>& neg) const {
+    std::unordered_set<std::string> projectedPos;
+    projectedPos.reserve(pos.size());
+    for (auto& word : pos) projectedPos.insert(project(word));
+    for (auto& word : neg) if (projectedPos.count(project(word))) return false;
+    return true;
+}
+
+bool paresy_s::AlphabetClasses::isSwapInvariant(char a, char b, const std::vector<std::string>& words, const std::unordered_set<std::string>& set) {
+    std::string swapped;
+    for (auto& word : words) {
+        swapped = word;
+        for (auto& ch : swapped) {
+            if (ch == a) ch = b;
+            else if (ch == b) ch = a;
+        }
+        if (!set.count(swapped)) return false;
+    }
+    return true;
+}
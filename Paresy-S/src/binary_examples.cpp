@@ -0,0 +1,172 @@
+#include <binary_examples.hpp>
+
+#include <set>
+#include <fstream>
+#include <cstring>
+
+using paresy_s::BinaryExamplesHeader;
+using paresy_s::binaryExamplesHeaderSize;
+
+void writeNumber(std::string& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+uint64_t readNumber(const uint8_t*& it, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) value |= static_cast<uint64_t>(*it++) << (8 * i);
+    return value;
+}
+
+// The header in little-endian whatever the byte order of the host
+std::string encodeHeader(const BinaryExamplesHeader& h) {
+    std::string out(h.magic, sizeof(h.magic));
+    writeNumber(out, h.version, 4);
+    writeNumber(out, h.alphabetSize, 4);
+    writeNumber(out, h.flags, 4);
+    writeNumber(out, h.posCount, 8);
+    writeNumber(out, h.negCount, 8);
+    writeNumber(out, h.posOffset, 8);
+    writeNumber(out, h.negOffset, 8);
+    writeNumber(out, h.endOffset, 8);
+    out.append(h.alphabet, sizeof(h.alphabet));
+    return out;
+}
+
+BinaryExamplesHeader decodeHeader(const uint8_t* it) {
+    BinaryExamplesHeader h = {};
+    memcpy(h.magic, it, sizeof(h.magic));
+    it += sizeof(h.magic);
+    h.version = static_cast<uint32_t>(readNumber(it, 4));
+    h.alphabetSize = static_cast<uint32_t>(readNumber(it, 4));
+    h.flags = static_cast<uint32_t>(readNumber(it, 4));
+    h.posCount = readNumber(it, 8);
+    h.negCount = readNumber(it, 8);
+    h.posOffset = readNumber(it, 8);
+    h.negOffset = readNumber(it, 8);
+    h.endOffset = readNumber(it, 8);
+    memcpy(h.alphabet, it, sizeof(h.alphabet));
+    return h;
+}
+
+void writeLength(std::string& out, uint64_t length) {
+    do {
+        uint8_t byte = length & 0x7F;
+        length >>= 7;
+        if (length) byte |= 0x80;
+        out.push_back(static_cast<char>(byte));
+    } while (length);
+}
+
+// Returns false if the length runs over the end
+bool readLength(const uint8_t*& it, const uint8_t* end, uint64_t& length) {
+    length = 0;
+    for (int shift = 0; it < end && shift < 64; shift += 7) {
+        uint8_t byte = *it++;
+        length |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+void writeWord(std::string& out, const std::string& word, const uint8_t* codes) {
+    writeLength(out, word.size());
+    for (auto c : word) out.push_back(static_cast<char>(codes[static_cast<uint8_t>(c)]));
+}
+
+bool paresy_s::writeBinaryExamples(const std::string& fileName, const std::vector<std::string>& pos, const std::vector<std::string>& neg) {
+
+    BinaryExamplesHeader header = {};
+    memcpy(header.magic, binaryExamplesMagic, sizeof(header.magic));
+    header.version = binaryExamplesVersion;
+
+    // The order of std::string, which compares the bytes as unsigned
+    std::set<uint8_t> alphabet;
+    for (auto& word : pos) for (auto ch : word) alphabet.insert(static_cast<uint8_t>(ch));
+    for (auto& word : neg) for (auto ch : word) alphabet.insert(static_cast<uint8_t>(ch));
+
+    uint8_t codes[256] = {};
+    for (auto ch : alphabet) {
+        codes[ch] = static_cast<uint8_t>(header.alphabetSize);
+        header.alphabet[header.alphabetSize++] = static_cast<char>(ch);
+    }
+
+    std::string body;
+    for (auto& word : pos) writeWord(body, word, codes);
+    uint64_t negStart = body.size();
+    for (auto& word : neg) writeWord(body, word, codes);
+
+    header.posCount = pos.size();
+    header.negCount = neg.size();
+    header.posOffset = binaryExamplesHeaderSize;
+    header.negOffset = header.posOffset + negStart;
+    header.endOffset = header.posOffset + body.size();
+
+    std::ofstream file(fileName, std::ios::binary);
+    if (!file.is_open()) {
+        printf("Unable to open the file");
+        return false;
+    }
+    std::string encoded = encodeHeader(header);
+    file.write(encoded.data(), encoded.size());
+    file.write(body.data(), body.size());
+    return static_cast<bool>(file);
+}
+
+bool paresy_s::isBinaryExamples(const std::string& fileName) {
+    std::ifstream file(fileName, std::ios::binary);
+    char magic[4] = {};
+    file.read(magic, sizeof(magic));
+    return file && memcmp(magic, binaryExamplesMagic, sizeof(magic)) == 0;
+}
+
+bool paresy_s::BinaryExamples::open(const std::string& fileName) {
+    file.reset(new MappedFile(fileName));
+    if (!file->isOpen()) {
+        printf("Unable to open the file");
+        return false;
+    }
+
+    if (file->size() < binaryExamplesHeaderSize || memcmp(file->data(), binaryExamplesMagic, sizeof(binaryExamplesMagic)) != 0) {
+        printf("\"%s\" isn't a binary example set", fileName.c_str());
+        return false;
+    }
+
+    h = decodeHeader(reinterpret_cast<const uint8_t*>(file->data()));
+    if (h.version != binaryExamplesVersion || h.alphabetSize > 256 || h.posOffset < binaryExamplesHeaderSize ||
+        h.posOffset > h.negOffset || h.negOffset > h.endOffset || h.endOffset > file->size()) {
+        printf("\"%s\" is corrupted or has an unsupported version (%u)", fileName.c_str(), h.version);
+        return false;
+    }
+
+    return true;
+}
+
+void paresy_s::BinaryExamples::decodeSection(uint64_t offset, uint64_t count, std::vector<std::string>& words) const {
+    auto it = reinterpret_cast<const uint8_t*>(file->data()) + offset;
+    auto end = reinterpret_cast<const uint8_t*>(file->data()) + h.endOffset;
+
+    words.reserve(words.size() + count);
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t length;
+        if (!readLength(it, end, length) || length > static_cast<uint64_t>(end - it)) {
+            printf("The binary example set is truncated\n");
+            return;
+        }
+        std::string word(length, '\0');
+        for (uint64_t j = 0; j < length; ++j) word[j] = h.alphabet[it[j]];
+        words.push_back(std::move(word));
+        it += length;
+    }
+}
+
+void paresy_s::BinaryExamples::decode(std::vector<std::string>& pos, std::vector<std::string>& neg) const {
+    decodeSection(h.posOffset, h.posCount, pos);
+    decodeSection(h.negOffset, h.negCount, neg);
+}
+
+bool paresy_s::readBinaryFile(const std::string& fileName, std::vector<std::string>& pos, std::vector<std::string>& neg) {
+    BinaryExamples examples;
+    if (!examples.open(fileName)) return false;
+    examples.decode(pos, neg);
+    return pos.size() == examples.header().posCount && neg.size() == examples.header().negCount;
+}
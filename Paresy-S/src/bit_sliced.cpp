@@ -0,0 +1,70 @@
+#include <bit_sliced.hpp>
+
+paresy_s::BitSlicedBatch::BitSlicedBatch(int ICsize)
+    : ICsize(ICsize), words((ICsize + 63) / 64), slices(words * 64, 0)
+{
+}
+
+void paresy_s::transpose64(uint64_t rows[64]) {
+    uint64_t mask = 0x00000000FFFFFFFFULL;
+    for (int j = 32; j != 0; j >>= 1, mask ^= (mask << j)) {
+        for (int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+            uint64_t t = ((rows[k] >> j) ^ rows[k | j]) & mask;
+            rows[k] ^= t << j;
+            rows[k | j] ^= t;
+        }
+    }
+}
+
+void paresy_s::BitSlicedBatch::load(const HostLanguageCache& cache, const int* indices, int count) {
+    uint64_t* block = slices.data();
+    for (int w = 0; w < words; ++w, block += 64) {
+        for (int k = 0; k < 64; ++k) block[k] = k < count ? cache.word(w, indices[k]) : 0;
+        transpose64(block);
+    }
+}
+
+void paresy_s::BitSlicedBatch::store(CS* css, int count) const {
+    uint64_t block[64];
+    for (int w = 0; w < words; ++w) {
+        for (int k = 0; k < 64; ++k) block[k] = slices[w * 64 + k];
+        transpose64(block);
+        for (int k = 0; k < count; ++k) css[k].setWord(w, block[k]);
+    }
+}
+
+void paresy_s::slicedStar(const HostGuideTable& guideTable, BitSlicedBatch& batch) {
+
+    batch[0] = ~(uint64_t)0;
+
+    // the splits of a word only point to shorter words, which are already closed
+    for (int ix = guideTable.alphabetSize + 1; ix < guideTable.ICsize; ++ix) {
+        uint64_t bits = batch[ix];
+        for (auto split = guideTable.rowBegin(ix); split != guideTable.rowEnd(ix); ++split)
+            bits |= batch[split->left] & batch[split->right];
+        batch[ix] = bits;
+    }
+}
+
+void paresy_s::slicedConcatenate(const HostGuideTable& guideTable, const BitSlicedBatch& left, const BitSlicedBatch& right,
+    BitSlicedBatch& lr, BitSlicedBatch& rl) {
+
+    // when one side contains epsilon, the other side is part of the result
+    uint64_t leftEps = left[0], rightEps = right[0];
+    for (int ix = 0; ix <= guideTable.alphabetSize; ++ix) {
+        uint64_t bits = (leftEps & right[ix]) | (rightEps & left[ix]);
+        lr[ix] = bits;
+        rl[ix] = bits;
+    }
+
+    for (int ix = guideTable.alphabetSize + 1; ix < guideTable.ICsize; ++ix) {
+        uint64_t bits = (leftEps & right[ix]) | (rightEps & left[ix]);
+        uint64_t lrBits = bits, rlBits = bits;
+        for (auto split = guideTable.rowBegin(ix); split != guideTable.rowEnd(ix); ++split) {
+            lrBits |= left[split->left] & right[split->right];
+            rlBits |= right[split->left] & left[split->right];
+        }
+        lr[ix] = lrBits;
+        rl[ix] = rlBits;
+    }
+}
@@ -0,0 +1,45 @@
+#include <char_classes.hpp>
+
+#include <map>
+#include <algorithm>
+
+std::vector<std::string> paresy_s::usefulCharClasses(const std::vector<std::string>& pos, const std::vector<std::string>& neg, size_t maxCount) {
+
+    std::set<char> alphabet;
+    for (auto& word : pos) for (auto ch : word) alphabet.insert(ch);
+    for (auto& word : neg) for (auto ch : word) alphabet.insert(ch);
+
+    if (alphabet.size() < 2 || maxCount == 0) return {};
+
+    // The characters seen between each pair of neighbours, '\0' stands for the start and the end of a word
+    std::map<std::pair<char, char>, std::set<char>> contexts;
+    for (auto& word : pos) {
+        for (size_t i = 0; i < word.size(); ++i) {
+            char left = i == 0 ? '\0' : word[i - 1];
+            char right = i + 1 == word.size() ? '\0' : word[i + 1];
+            contexts[{ left, right }].insert(word[i]);
+        }
+    }
+
+    std::map<std::string, int> frequency;
+    for (auto& [context, members] : contexts) {
+        if (members.size() < 2) continue;
+        frequency[std::string(members.begin(), members.end())]++;
+    }
+    frequency[std::string(alphabet.begin(), alphabet.end())]++;
+
+    std::vector<std::pair<std::string, int>> classes(frequency.begin(), frequency.end());
+    std::stable_sort(classes.begin(), classes.end(), [](const auto& a, const auto& b) {
+        if (a.second != b.second) return a.second > b.second;
+        return a.first.size() > b.first.size();
+    });
+
+    std::vector<std::string> res;
+    for (size_t i = 0; i < classes.size() && res.size() < maxCount; ++i)
+        res.push_back(classes[i].first);
+    return res;
+}
+
+std::string paresy_s::charClassString(const std::string& members) {
+    return "[" + members + "]";
+}
@@ -0,0 +1,286 @@
+#include <checkpoint.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#ifndef CHECKPOINT_KEEP
+#define CHECKPOINT_KEEP 4
+#endif
+
+using paresy_s::Opreation;
+using paresy_s::Checkpoint;
+using paresy_s::CostIntervals;
+using paresy_s::HostContext;
+using paresy_s::MappedFile;
+
+namespace {
+    const char checkpointMagic[8] = { 'P', 'R', 'S', 'Y', 'C', 'K', 'P', '2' };
+    const int opCount = static_cast<int>(Opreation::Count);
+
+    // The level records follow it up to bytes, the ones after it are left by an interrupted save.
+    // It is written last, so it only covers the records that are complete
+    struct CheckpointHeader {
+        char magic[8];
+        uint64_t key;
+        uint64_t capacity;
+        uint64_t count;
+        uint64_t allREs;
+        uint64_t bytes;
+        uint32_t csBytes;
+        int32_t cost;
+        int32_t shortageCost;
+        int32_t onTheFly;
+        int32_t lastEnd;
+    };
+
+    // The REs and the levels that a save adds. It is followed by the CSs, the left and right indices of them,
+    // and the start of every operation of the levels from firstCost to lastCost
+    struct LevelRecord {
+        uint64_t count;
+        int32_t firstCost;
+        int32_t lastCost;
+    };
+
+    // FNV-1a
+    uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+        auto bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) { hash ^= bytes[i]; hash *= 0x100000001b3ULL; }
+        return hash;
+    }
+
+    // The size of a record with count REs and levels levels
+    size_t recordBytes(size_t count, int levels) {
+        return sizeof(LevelRecord) + count * (sizeof(CS) + 2 * sizeof(int)) + static_cast<size_t>(levels) * opCount * sizeof(int);
+    }
+
+    // Writing the REs from firstIdx on and the levels from firstCost to cost
+    bool writeRecord(FILE* file, const HostContext& context, const CostIntervals& intervals, size_t firstIdx, int firstCost, int cost) {
+        LevelRecord record{ context.lastIdx - firstIdx, firstCost, cost };
+        size_t count = record.count;
+        bool written = fwrite(&record, sizeof(record), 1, file) == 1;
+
+        const size_t chunk = 1 << 16;
+        std::vector<CS> css;
+        for (size_t first = 0; written && first < count; first += chunk) {
+            size_t n = std::min(chunk, count - first);
+            css.resize(n);
+            for (size_t i = 0; i < n; ++i) css[i] = context.langCache[firstIdx + first + i];
+            written = fwrite(css.data(), sizeof(CS), n, file) == n;
+        }
+        written = written && fwrite(context.leftIdx.data() + firstIdx, sizeof(int), count, file) == count;
+        written = written && fwrite(context.rightIdx.data() + firstIdx, sizeof(int), count, file) == count;
+
+        std::vector<int> starts;
+        for (int c = firstCost; c <= cost; ++c)
+            for (int op = 0; op < opCount; ++op) starts.push_back(intervals.start(c, static_cast<Opreation>(op)));
+        return written && fwrite(starts.data(), sizeof(int), starts.size(), file) == starts.size();
+    }
+}
+
+Checkpoint::Checkpoint(const std::string& directory, const unsigned short* costFun,
+    const std::vector<std::string>& pos, const std::vector<std::string>& neg, const std::vector<paresy_s::Seed>& seeds) : key(0xcbf29ce484222325ULL)
+{
+    if (directory.empty()) return;
+
+    key = hashBytes(key, costFun, 6 * sizeof(unsigned short));
+
+    // The options that change what is stored. The memory is checked on loading, a larger one can continue
+    // a snapshot that has not switched to "OnTheFly" yet
+    const int build[] = { static_cast<int>(sizeof(CS)), CHAR_CLASS_COST, CHAR_CLASS_MAX_COUNT, RELAX_UNIQUENESS_CHECK_TYPE, HOST_DISK > 0 };
+    key = hashBytes(key, build, sizeof(build));
+
+    for (auto& word : pos) key = hashBytes(hashBytes(key, word.data(), word.size()), "\n", 1);
+    key = hashBytes(key, "", 1);
+    for (auto& word : neg) key = hashBytes(hashBytes(key, word.data(), word.size()), "\n", 1);
+    key = hashBytes(key, "", 1);
+    for (auto& seed : seeds) key = hashBytes(hashBytes(hashBytes(key, seed.RE.data(), seed.RE.size()), "\n", 1), &seed.cost, sizeof(seed.cost));
+
+    char name[40];
+    snprintf(name, sizeof(name), "paresy-s-%016llx.ckpt", static_cast<unsigned long long>(key));
+    path = (std::filesystem::path(directory) / name).string();
+}
+
+bool Checkpoint::save(const HostContext& context, const CostIntervals& intervals, int cost, int shortageCost)
+{
+    if (!enabled()) return false;
+
+    CheckpointHeader header{};
+    memcpy(header.magic, checkpointMagic, sizeof(header.magic));
+    header.key = key;
+    header.capacity = context.capacity;
+    header.count = context.lastIdx;
+    header.allREs = context.allREs;
+    header.csBytes = sizeof(CS);
+    header.cost = cost;
+    header.shortageCost = shortageCost;
+    header.onTheFly = context.onTheFly;
+    header.lastEnd = intervals.end(cost, Opreation::And);
+
+    // Only the REs and the levels since the last save are appended, while the file is still the one that it
+    // has left. The header goes in place of the old one once they are written
+    if (savedCost != -1 && savedCost < cost && savedCount <= context.lastIdx) {
+        CheckpointHeader old;
+        FILE* file = fopen(path.c_str(), "rb");
+        bool same = file && fread(&old, sizeof(old), 1, file) == 1;
+        if (file) fclose(file);
+
+        std::error_code error;
+        auto size = std::filesystem::file_size(path, error);
+        same = same && !error && memcmp(old.magic, checkpointMagic, sizeof(old.magic)) == 0 && old.key == key &&
+            old.count == savedCount && old.cost == savedCost && old.bytes == size;
+
+        if (same) {
+            header.bytes = size + recordBytes(context.lastIdx - savedCount, cost - savedCost);
+            file = fopen(path.c_str(), "ab");
+            bool written = file && writeRecord(file, context, intervals, savedCount, savedCost + 1, cost);
+            written = file && fclose(file) == 0 && written;
+
+            file = written ? fopen(path.c_str(), "r+b") : nullptr;
+            written = file && fwrite(&header, sizeof(header), 1, file) == 1;
+            written = file && fclose(file) == 0 && written;
+
+            if (written) {
+                savedCount = context.lastIdx;
+                savedCost = cost;
+                return true;
+            }
+            // the old header may be left with a torn record after it, the next save writes the file again
+            savedCost = -1;
+            return false;
+        }
+    }
+
+    // The first save writes all of it, it replaces a previous snapshot only once it is complete
+    header.bytes = sizeof(header) + recordBytes(context.lastIdx, cost + 1);
+    std::string temp = path + ".tmp";
+    FILE* file = fopen(temp.c_str(), "wb");
+    if (!file) return false;
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+    written = written && writeRecord(file, context, intervals, 0, 0, cost);
+    written = fclose(file) == 0 && written;
+    if (!written) { std::remove(temp.c_str()); return false; }
+
+    std::error_code error;
+    std::filesystem::rename(temp, path, error);
+    if (error) return false;
+
+    savedCount = context.lastIdx;
+    savedCost = cost;
+    evict();
+    return true;
+}
+
+void Checkpoint::evict() const
+{
+    namespace fs = std::filesystem;
+
+    // The snapshots of the other runs, the ones of the examples that are never run again pile up otherwise
+    std::vector<std::pair<fs::file_time_type, fs::path>> others;
+    std::error_code error;
+    for (fs::directory_iterator it(fs::path(path).parent_path(), error), end; !error && it != end; it.increment(error)) {
+        auto name = it->path().filename().string();
+        if (it->path() == fs::path(path) || name.rfind("paresy-s-", 0) != 0 || it->path().extension() != ".ckpt") continue;
+        auto time = it->last_write_time(error);
+        if (!error) others.emplace_back(time, it->path());
+        error.clear();
+    }
+
+    // The newest ones are kept along with this one, up to CHECKPOINT_KEEP in all
+    size_t keep = CHECKPOINT_KEEP > 1 ? CHECKPOINT_KEEP - 1 : 0;
+    if (others.size() <= keep) return;
+    std::sort(others.begin(), others.end(), [](auto& a, auto& b) { return a.first > b.first; });
+    for (size_t i = keep; i < others.size(); ++i) fs::remove(others[i].second, error);
+}
+
+int Checkpoint::load(HostContext& context, CostIntervals& intervals, int maxCost, int& shortageCost)
+{
+    if (!enabled()) return -1;
+
+    MappedFile file(path);
+    if (!file.isOpen() || file.size() < sizeof(CheckpointHeader)) return -1;
+
+    CheckpointHeader header;
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.magic, checkpointMagic, sizeof(header.magic)) != 0 || header.key != key || header.csBytes != sizeof(CS)) return -1;
+    if (header.cost < 0 || header.cost >= maxCost || header.bytes > file.size()) return -1;
+
+    // After the switch to "OnTheFly" the levels depend on the capacity, before it a larger one gives the same ones
+    if (header.onTheFly ? header.capacity != context.capacity : header.count > context.capacity) return -1;
+
+    // The records have to add up to the header before anything is taken from them
+    size_t offset = sizeof(header), count = 0;
+    int cost = -1;
+    while (offset < header.bytes) {
+        LevelRecord record;
+        if (header.bytes - offset < sizeof(record)) return -1;
+        memcpy(&record, file.data() + offset, sizeof(record));
+        if (record.firstCost != cost + 1 || record.lastCost < record.firstCost || record.lastCost > header.cost) return -1;
+        if (record.count > header.count - count) return -1;
+        size_t size = recordBytes(record.count, record.lastCost - record.firstCost + 1);
+        if (header.bytes - offset < size) return -1;
+        offset += size;
+        count += record.count;
+        cost = record.lastCost;
+    }
+    if (count != header.count || cost != header.cost) return -1;
+
+    // The context has only the alphabet so far, all of it is in memory
+    context.langCache.resize(0);
+    context.leftIdx.resize(count);
+    context.rightIdx.resize(count);
+    context.visited.clear();
+    // Nothing is inserted into the hash set in "OnTheFly" mode
+    if (!header.onTheFly) {
+        context.visited.insert(CS());
+        context.visited.insert(CS::one());
+    }
+
+    // The records aren't aligned in the mapping, their arrays are copied out
+    size_t first = 0;
+    for (offset = sizeof(header); offset < header.bytes;) {
+        LevelRecord record;
+        memcpy(&record, file.data() + offset, sizeof(record));
+        const char* data = file.data() + offset + sizeof(record);
+        size_t n = record.count;
+
+        for (size_t i = 0; i < n; ++i) {
+            CS cs;
+            memcpy(&cs, data + i * sizeof(CS), sizeof(CS));
+            context.langCache.push_back(cs);
+            if (!header.onTheFly) context.visited.insert(cs);
+        }
+        data += n * sizeof(CS);
+        memcpy(context.leftIdx.data() + first, data, n * sizeof(int));
+        data += n * sizeof(int);
+        memcpy(context.rightIdx.data() + first, data, n * sizeof(int));
+        data += n * sizeof(int);
+
+        for (int c = record.firstCost; c <= record.lastCost; ++c)
+            for (int op = 0; op < opCount; ++op, data += sizeof(int))
+                memcpy(&intervals.start(c, static_cast<Opreation>(op)), data, sizeof(int));
+
+        first += n;
+        offset += recordBytes(n, record.lastCost - record.firstCost + 1);
+    }
+    intervals.end(header.cost, Opreation::And) = header.lastEnd;
+
+    context.lastIdx = count;
+    context.allREs = header.allREs;
+    context.onTheFly = header.onTheFly;
+
+    // The next save appends to it
+    savedCount = count;
+    savedCost = header.cost;
+
+    shortageCost = header.shortageCost;
+    return header.cost;
+}
+
+void Checkpoint::remove()
+{
+    if (enabled()) std::remove(path.c_str());
+    savedCost = -1;
+}
@@ -0,0 +1,24 @@
+#include <string>
+#include <vector>
+
+#include "rei_util.hpp"
+#include "binary_examples.hpp"
+
+int main(int argc, char* argv[]) {
+
+    if (argc != 3) {
+        printf("Arguments should be in the form of\n");
+        printf("-----------------------------------------------------------------\n");
+        printf("%s <text_file_address> <binary_file_address>\n", argv[0]);
+        printf("-----------------------------------------------------------------\n");
+        return 0;
+    }
+
+    std::vector<std::string> pos, neg;
+    if (!paresy_s::readMappedFile(argv[1], pos, neg)) return 1;
+
+    if (!paresy_s::writeBinaryExamples(argv[2], pos, neg)) return 1;
+
+    printf("Pos: %zu, Neg: %zu\n", pos.size(), neg.size());
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <ic_projection.hpp>
+
+#include <set>
+
+using paresy_s::ICProjection;
+using paresy_s::SampleClosure;
+using paresy_s::HostExamples;
+using paresy_s::WordSelection;
+
+// Above this many infixes of the root examples, counted with the duplicates, its infix-closure takes more memory
+// than the generation of the small ones of the windows costs
+const size_t maxProjectedInfixes = 1 << 20;
+
+ICProjection::ICProjection(const std::vector<std::string>& pos, const std::vector<std::string>& neg) : enabled(false), rootSize(pos.size() + neg.size())
+{
+    size_t infixes = 0;
+    for (auto& word : pos) infixes += (word.size() + 1) * (word.size() + 2) / 2;
+    for (auto& word : neg) infixes += (word.size() + 1) * (word.size() + 2) / 2;
+    if (infixes > maxProjectedInfixes) return;
+
+    std::set<std::string, strComparison> ic = generatingIC(pos, neg);
+    guideTable = HostGuideTable(ic);
+
+    int ix = 0;
+    for (auto it = ic.begin(); it != ic.end(); ++it, ++ix) examples.emplace(*it, ix);
+    // only the examples are looked up
+    std::unordered_map<std::string, int> kept;
+    for (auto& word : pos) kept.emplace(word, examples.at(word));
+    for (auto& word : neg) kept.emplace(word, examples.at(word));
+    examples.swap(kept);
+
+    enabled = true;
+}
+
+HostExamples ICProjection::project(const std::vector<std::string>& pos, const std::vector<std::string>& neg) const
+{
+    if (!enabled) return HostExamples(pos, neg);
+
+    WordSelection selection(guideTable.ICsize);
+    for (auto* words : { &pos, &neg }) {
+        for (auto& word : *words) {
+            auto it = examples.find(word);
+            if (it == examples.end()) return HostExamples(pos, neg);
+            selection.set(it->second);
+        }
+    }
+
+    // The splits of a word only point to shorter words, so a pass from the longest one down selects all the infixes
+    selection.set(0);
+    for (int ix = guideTable.ICsize - 1; ix > guideTable.alphabetSize; --ix) {
+        if (selection.block(ix) == 0) { ix -= ix % 64; continue; }
+        if (!selection.test(ix)) continue;
+        for (auto split = guideTable.rowBegin(ix); split != guideTable.rowEnd(ix); ++split) {
+            selection.set(split->left);
+            selection.set(split->right);
+        }
+    }
+    selection.seal();
+
+    // too large for a CS, the generation of the words reports it
+    if (selection.count() > static_cast<int>(sizeof(CS) * 8)) return HostExamples(pos, neg);
+
+    CS posBits{}, negBits{};
+    for (auto& word : pos) posBits.set(selection.rank(examples.at(word)));
+    for (auto& word : neg) negBits.set(selection.rank(examples.at(word)));
+
+    return HostExamples(guideTable.project(selection), posBits, negBits);
+}
+
+SampleClosure::SampleClosure(const ICProjection& ic, int budget)
+    : ic(ic), budget(budget), selection(ic.enabled ? ic.guideTable.ICsize : 0)
+{
+    if (ic.enabled) selection.set(0);
+    else infixes.insert("");
+}
+
+bool SampleClosure::add(const std::string& word)
+{
+    if (!ic.enabled) {
+        std::vector<std::string> added;
+        for (size_t i = 0; i < word.size(); ++i)
+            for (size_t j = 1; i + j <= word.size(); ++j)
+                if (infixes.insert(word.substr(i, j)).second) added.push_back(word.substr(i, j));
+
+        if (count + static_cast<int>(added.size()) > budget) {
+            for (auto& infix : added) infixes.erase(infix);
+            return false;
+        }
+        count += static_cast<int>(added.size());
+        return true;
+    }
+
+    auto it = ic.examples.find(word);
+    if (it == ic.examples.end()) return false;
+
+    // The infixes that are new to the sample, an infix that is in it already has all of its own in it too
+    std::vector<int> added, stack{ it->second };
+    while (!stack.empty()) {
+        int ix = stack.back();
+        stack.pop_back();
+        if (selection.test(ix)) continue;
+
+        selection.set(ix);
+        added.push_back(ix);
+        for (auto split = ic.guideTable.rowBegin(ix); split != ic.guideTable.rowEnd(ix); ++split) {
+            stack.push_back(split->left);
+            stack.push_back(split->right);
+        }
+    }
+
+    if (count + static_cast<int>(added.size()) > budget) {
+        for (int ix : added) selection.reset(ix);
+        return false;
+    }
+    count += static_cast<int>(added.size());
+    return true;
+}
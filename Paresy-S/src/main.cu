@@ -3,20 +3,25 @@
 #include <chrono>
 #include <cassert>
 #include <cmath>
+#include <climits>
 
 #include <regex_match.hpp>
 #include "rei_dc.hpp"
 #include "rei_util.hpp"
+#include "binary_examples.hpp"
+#include "cost_intervals.h"
 
 int calculateCost(const std::string& pattren, unsigned short* costFun) {
     auto counts = paresy_s::countOpreations(pattren);
+    paresy_s::Costs costs(costFun); // the class cost as the enumeration has used it
     int count = 0;
-    count += counts.alpha * costFun[0];
-    count += counts.question * costFun[1];
-    count += counts.star * costFun[2];
-    count += counts.concat * costFun[3];
-    count += counts.alternation * costFun[4];
-    count += counts.intersection * costFun[5];
+    count += counts.alpha * costs.alpha;
+    count += counts.question * costs.question;
+    count += counts.star * costs.star;
+    count += counts.concat * costs.concat;
+    count += counts.alternation * costs.alternation;
+    count += counts.intersection * costs.intersection;
+    count += counts.charClass * costs.charClass;
     return count;
 }
 
@@ -51,7 +56,8 @@ int main(int argc, char* argv[]) {
 
     std::string fileName = argv[1];
     std::vector<std::string> pos, neg;
-    if (!paresy_s::readFile(fileName, pos, neg)) return 0;
+    if (paresy_s::isBinaryExamples(fileName)) { if (!paresy_s::readBinaryFile(fileName, pos, neg)) return 0; }
+    else if (!paresy_s::readMappedFile(fileName, pos, neg)) return 0;
 
     unsigned short dc_type = std::atoi(argv[2]);
     unsigned short window_size = std::atoi(argv[3]);
@@ -120,6 +126,8 @@ int main(int argc, char* argv[]) {
     std::string result;
     if (dc_type == 1)
         result = paresy_s::randSplit(window_size, costFun, maxCost, pos, neg, max_time, profileInfo);
+    else if (dc_type == 3)
+        result = paresy_s::mergeSplit(window_size, costFun, maxCost, pos, neg, max_time, profileInfo);
     else
         result = paresy_s::detSplit(window_size, costFun, maxCost, pos, neg, max_time, profileInfo);
 
@@ -137,6 +145,7 @@ int main(int argc, char* argv[]) {
     auto finalCost = calculateCost(result, costFun);
     printf("\nFinal Cost: %u", finalCost);
     printf("\nCall count: %d, Max depth: %d\n", profileInfo.callCount, profileInfo.maxDepth);
+    printf("Match calls: %llu, Exhaustive match calls: %llu\n", profileInfo.matchCalls, profileInfo.exhaustiveMatchCalls);
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count();
     printf("\nRunning Time: %f s", (double)duration * 0.000001);
     printf("\n\nRE: \"%s\"\n", result.c_str());
@@ -172,7 +181,8 @@ if (argError) return 0;
 
 std::string fileName = argv[1];
 std::vector<std::string> pos, neg;
-if (!paresy_s::readFile(fileName, pos, neg)) return 0;
+if (paresy_s::isBinaryExamples(fileName)) { if (!paresy_s::readBinaryFile(fileName, pos, neg)) return 0; }
+else if (!paresy_s::readMappedFile(fileName, pos, neg)) return 0;
 
 unsigned short dc_type = std::atoi(argv[2]);
 unsigned short window_size = std::atoi(argv[3]);
@@ -203,6 +213,8 @@ auto start = std::chrono::high_resolution_clock::now();
 std::string result;
 if (dc_type == 1)
 result = paresy_s::randSplit(window_size, costFun, maxCost, pos_train, neg_train, max_time, profileInfo);
+else if (dc_type == 3)
+result = paresy_s::mergeSplit(window_size, costFun, maxCost, pos_train, neg_train, max_time, profileInfo);
 else
 result = paresy_s::detSplit(window_size, costFun, maxCost, pos_train, neg_train, max_time, profileInfo);
 
@@ -250,6 +262,7 @@ printf("\nFinal Cost: %u", finalCost);
 printf("\nTruePositive=%u, FalsePositive=%u, TrueNegative=%u, FalseNegative=%u", tp, fp, tn, fn);
 printf("\nAccuracy=%f, Precision=%f, Recall=%f, F1-score=%f", accuracy, precision, recall, f1);
 printf("\nCall count: %d, Max depth: %d\n", profileInfo.callCount, profileInfo.maxDepth);
+printf("Match calls: %llu, Exhaustive match calls: %llu\n", profileInfo.matchCalls, profileInfo.exhaustiveMatchCalls);
 auto duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count();
 printf("\nRunning Time: %f s", (double)duration * 0.000001);
 printf("\n\nRE: \"%s\"\n", result.c_str());
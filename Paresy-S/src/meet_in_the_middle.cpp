@@ -0,0 +1,111 @@
+#include <meet_in_the_middle.hpp>
+
+#include <algorithm>
+#include <unordered_set>
+
+uint64_t lowBits(int count) {
+    return count >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << count) - 1;
+}
+
+paresy_s::ProjectionIndex::ProjectionIndex(int width) : width(width) {
+    if (width <= maxTableWidth) table.assign((size_t)1 << width, -1);
+}
+
+void paresy_s::ProjectionIndex::add(uint64_t key, int index) {
+    if (!table.empty()) { if (table[key] == -1) table[key] = index; }
+    else keys.emplace(key, index);
+}
+
+void paresy_s::ProjectionIndex::build() {
+    if (!table.empty()) {
+        // Every mask takes an entry from one of its supersets
+        for (int bit = 0; bit < width; ++bit) {
+            size_t b = (size_t)1 << bit;
+            for (size_t m = 0; m < table.size(); ++m)
+                if (!(m & b) && table[m] == -1) table[m] = table[m | b];
+        }
+        return;
+    }
+
+    sortedKeys.assign(keys.begin(), keys.end());
+    keys.clear();
+    std::sort(sortedKeys.begin(), sortedKeys.end());
+
+    // The leaves are at n..2n-1, every node is the OR of its two children
+    int n = static_cast<int>(sortedKeys.size());
+    orTree.assign(2 * (size_t)n, 0);
+    for (int i = 0; i < n; ++i) orTree[n + i] = sortedKeys[i].first;
+    for (int i = n - 1; i > 0; --i) orTree[i] = orTree[2 * i] | orTree[2 * i + 1];
+}
+
+int paresy_s::ProjectionIndex::findSuperset(uint64_t need) const {
+    if (!table.empty()) return table[need];
+    return search(need, 0, static_cast<int>(sortedKeys.size()), width - 1);
+}
+
+int paresy_s::ProjectionIndex::search(uint64_t need, int lo, int hi, int bit) const {
+    if (lo >= hi || (rangeOr(lo, hi) & need) != need) return -1;
+    // The keys are distinct, so a range of one key is a leaf
+    if (hi - lo == 1) return sortedKeys[lo].second;
+
+    // The keys of the range agree on the bits above bit, so the ones with bit set are at its end
+    uint64_t b = (uint64_t)1 << bit;
+    auto mid = static_cast<int>(std::partition_point(sortedKeys.begin() + lo, sortedKeys.begin() + hi,
+        [b](const std::pair<uint64_t, int>& key) { return !(key.first & b); }) - sortedKeys.begin());
+
+    int found = search(need, mid, hi, bit - 1);
+    if (found != -1 || (need & b)) return found;
+    return search(need, lo, mid, bit - 1);
+}
+
+uint64_t paresy_s::ProjectionIndex::rangeOr(int lo, int hi) const {
+    uint64_t res = 0;
+    auto n = static_cast<int>(sortedKeys.size());
+    for (lo += n, hi += n; lo < hi; lo >>= 1, hi >>= 1) {
+        if (lo & 1) res |= orTree[lo++];
+        if (hi & 1) res |= orTree[--hi];
+    }
+    return res;
+}
+
+paresy_s::Pair<int> paresy_s::findAlternation(const Projection* projections, Pair<int> left, Pair<int> right, int posCount) {
+
+    uint64_t allPos = lowBits(posCount);
+
+    ProjectionIndex index(posCount);
+    for (int i = right.left; i < right.right; ++i)
+        if (projections[i].neg == 0) index.add(projections[i].pos, i);
+    index.build();
+
+    std::unordered_set<uint64_t> tried;
+    for (int i = left.left; i < left.right; ++i) {
+        if (projections[i].neg != 0) continue;
+        if (!tried.insert(projections[i].pos).second) continue;
+        int partner = index.findSuperset(allPos & ~projections[i].pos);
+        if (partner != -1) return { i, partner };
+    }
+
+    return { -1, -1 };
+}
+
+paresy_s::Pair<int> paresy_s::findIntersection(const Projection* projections, Pair<int> left, Pair<int> right, int posCount, int negCount) {
+
+    uint64_t allPos = lowBits(posCount);
+    uint64_t allNeg = lowBits(negCount);
+
+    // B is a partner of A when neg(B) is inside the complement of neg(A), so the complements are indexed
+    ProjectionIndex index(negCount);
+    for (int i = right.left; i < right.right; ++i)
+        if (projections[i].pos == allPos) index.add(allNeg & ~projections[i].neg, i);
+    index.build();
+
+    std::unordered_set<uint64_t> tried;
+    for (int i = left.left; i < left.right; ++i) {
+        if (projections[i].pos != allPos) continue;
+        if (!tried.insert(projections[i].neg).second) continue;
+        int partner = index.findSuperset(projections[i].neg);
+        if (partner != -1) return { i, partner };
+    }
+
+    return { -1, -1 };
+}
@@ -0,0 +1,88 @@
+#include <re_string.hpp>
+
+bool paresy_s::isAtom(const std::string& s) {
+    return s.length() == 1 || (s.front() == '[' && s.find(']') == s.length() - 1);
+}
+
+std::string paresy_s::bracket(std::string s) {
+    int p = 0;
+    for (size_t i = 0; i < s.length(); i++) {
+        if (s[i] == '(') p++;
+        else if (s[i] == ')') p--;
+        else if ((s[i] == '+' || s[i] == '&') && p <= 0) return "(" + s + ")";
+    }
+    return s;
+}
+
+// Generating the final RE string recursively
+// When all the left and right indices are ready in the host
+std::string paresy_s::toString(
+    int index,
+    const Provenance& provenance,
+    const std::vector<std::string>& atoms,
+    const std::vector<std::string>& classAtoms,
+    const CostIntervals& intervals)
+{
+
+    if (index <= -3) return classAtoms[-3 - index]; // Character class
+    if (index == -2) return "eps"; // Epsilon
+    if (index == -1) return "Error";
+    if (index < static_cast<int>(atoms.size())) return atoms[index];
+
+    int cost; Opreation op;
+    intervals.indexToCost(index, cost, op);
+    return toString(index, op, provenance, atoms, classAtoms, intervals);
+}
+
+std::string paresy_s::toString(
+    int index,
+    Opreation op,
+    const Provenance& provenance,
+    const std::vector<std::string>& atoms,
+    const std::vector<std::string>& classAtoms,
+    const CostIntervals& intervals)
+{
+    if (provenance.left(index) <= -3) return toString(provenance.left(index), provenance, atoms, classAtoms, intervals);
+
+    if (op == Opreation::Question) {
+        std::string res = toString(provenance.left(index), provenance, atoms, classAtoms, intervals);
+        if (!isAtom(res)) return "(" + res + ")?";
+        return res + "?";
+    }
+
+    if (op == Opreation::Star) {
+        std::string res = toString(provenance.left(index), provenance, atoms, classAtoms, intervals);
+        if (!isAtom(res)) return "(" + res + ")*";
+        return res + "*";
+    }
+
+    if (op == Opreation::Concatenate) {
+        std::string left = toString(provenance.left(index), provenance, atoms, classAtoms, intervals);
+        std::string right = toString(provenance.right(index), provenance, atoms, classAtoms, intervals);
+        return bracket(left) + bracket(right);
+    }
+
+    if (op == Opreation::Or)
+    {
+        std::string left = toString(provenance.left(index), provenance, atoms, classAtoms, intervals);
+        std::string right = toString(provenance.right(index), provenance, atoms, classAtoms, intervals);
+        return left + "+" + right;
+    }
+
+    std::string left = toString(provenance.left(index), provenance, atoms, classAtoms, intervals);
+    std::string right = toString(provenance.right(index), provenance, atoms, classAtoms, intervals);
+    return left + "&" + right;
+}
+
+std::vector<paresy_s::Solution> paresy_s::toStrings(
+    const std::vector<FoundSolution>& found,
+    const Provenance& provenance,
+    const std::vector<std::string>& atoms,
+    const std::vector<std::string>& classAtoms,
+    const CostIntervals& intervals)
+{
+    std::vector<Solution> solutions;
+    for (int i = 0; i < static_cast<int>(found.size()); ++i)
+        solutions.push_back({ toString(Provenance::rootIndex(i), found[i].op, provenance, atoms, classAtoms, intervals), found[i].cost });
+    return solutions;
+}
@@ -1,10 +1,22 @@
 #include "regex_match.hpp"
 
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <memory>
+
+#include <worker_pool.hpp>
+
  Char::Char(char c) : c(c) {}
  bool Char::match(const string& word) const {
     return word.size() == 1 && word[0] == c;
 }
 
+ CharClass::CharClass(const string& chars) : chars(chars) {}
+ bool CharClass::match(const string& word) const {
+    return word.size() == 1 && chars.find(word[0]) != string::npos;
+}
+
  Or::Or(shared_ptr<Regex> l, shared_ptr<Regex> r) : left(l), right(r) {}
  bool Or::match(const string& word) const {
     return left->match(word) || right->match(word);
@@ -109,6 +121,16 @@
         if (get() != ')') throw runtime_error("Missing ')'");
         return node;
     }
+    else if (peek() == '[') {
+        get();
+        string chars;
+        while (peek() != ']') {
+            if (peek() == '\0') throw runtime_error("Missing ']'");
+            chars += get();
+        }
+        get();
+        return make_shared<CharClass>(chars);
+    }
     else {
         char c = get();
         return make_shared<Char>(c);
@@ -140,4 +162,68 @@
      }
 
      return res;
+ }
+
+ // Below this size the examples are checked on the calling thread
+ const size_t parallelCheckThreshold = 2048;
+ // The front of the order is always checked sequentially, it holds the examples that failed recently
+ const size_t sequentialPrefix = 64;
+
+ // The pool of the checks of the calling thread, it is made again only when another number of threads is asked for
+ paresy_s::WorkerPool& checkPool(int threads)
+ {
+     thread_local std::unique_ptr<paresy_s::WorkerPool> pool;
+     if (!pool || pool->size() != threads) pool = std::make_unique<paresy_s::WorkerPool>(threads);
+     return *pool;
+ }
+
+ long firstViolation(const vector<string>& examples, const vector<int>& order, const string& pattern, bool expected, unsigned long long& matchCalls,
+     int threads)
+ {
+     shared_ptr<Regex> tree;
+     if (pattern != "eps") tree = Parser(pattern).parse();
+
+     auto accepts = [&](int i) {
+         return tree ? tree->match(examples[i]) : examples[i].empty();
+     };
+
+     size_t prefix = order.size() < parallelCheckThreshold ? order.size() : sequentialPrefix;
+     for (size_t i = 0; i < prefix; ++i) {
+         matchCalls++;
+         if (accepts(order[i]) != expected) return static_cast<long>(i);
+     }
+
+     if (prefix == order.size()) return -1;
+
+     if (threads <= 0) threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+     size_t remaining = order.size() - prefix;
+     size_t workers = static_cast<size_t>(threads);
+     size_t chunk = (remaining + workers - 1) / workers;
+
+     std::atomic<long> violation(-1);
+     std::atomic<unsigned long long> calls(0);
+
+     int chunks = static_cast<int>((remaining + chunk - 1) / chunk);
+     checkPool(threads).run(chunks, [&](int c) {
+         size_t begin = prefix + c * chunk;
+         size_t end = std::min(order.size(), begin + chunk);
+         unsigned long long localCalls = 0;
+         for (size_t i = begin; i < end; ++i) {
+             // another chunk found a violation before this position, no need to continue
+             long found = violation.load(std::memory_order_relaxed);
+             if (found != -1 && found < static_cast<long>(i)) break;
+             localCalls++;
+             if (accepts(order[i]) != expected) {
+                 long current = violation.load();
+                 while ((current == -1 || current > static_cast<long>(i)) &&
+                     !violation.compare_exchange_weak(current, static_cast<long>(i))) {
+                 }
+                 break;
+             }
+         }
+         calls += localCalls;
+     });
+
+     matchCalls += calls;
+     return violation;
  }
\ No newline at end of file
@@ -1,40 +1,41 @@
 #include <rei.h>
 
-#include <map>
 #include <set>
 #include <tuple>
 #include <chrono>
+#include <vector>
+#include <functional>
 
 #include <cuda_runtime.h>
 #include <device_launch_parameters.h>
 #include <device_functions.h>
 
-#include <thrust/copy.h>
-#include <thrust/remove.h>
-#include <thrust/device_ptr.h>
 #include <warpcore/hash_set.cuh>
 
 #include <pair.h>
 #include <interval_splitter.h>
+#include <pair_mapping.h>
+#include <tile_scheduler.h>
+#include <language_cache.h>
 #include <bitmask.h>
+#include <cs.h>
+#include <cost_intervals.h>
+#include <re_string.hpp>
+#include <solution_set.hpp>
+#include <rei_util.hpp>
+#include <alphabet_classes.hpp>
+#include <seed_atoms.hpp>
+#include <meet_in_the_middle.hpp>
+#include <cost_batch.hpp>
 
 template <class T>
 using Pair = paresy_s::Pair<T>;
 
-#if CS_BIT_COUNT == 0
-using CS = paresy_s::bitmask<2>;
-#elif CS_BIT_COUNT == 1
-using CS = paresy_s::bitmask<4>;
-#elif CS_BIT_COUNT == 2
-using CS = paresy_s::bitmask<8>;
-#elif CS_BIT_COUNT == 3
-using CS = paresy_s::bitmask<16>;
-#elif CS_BIT_COUNT == 4
-using CS = paresy_s::bitmask<32>;
-#else
-using CS = paresy_s::bitmask<64>;
-#endif
-
+using paresy_s::strComparison;
+using paresy_s::checkTime;
+using paresy_s::Opreation;
+using paresy_s::Costs;
+using paresy_s::CostIntervals;
 
 #define HD __host__ __device__
 
@@ -72,40 +73,6 @@ size_t getFreeMemory() {
 
 // ============= guide table =============
 
-// Shortlex ordering
-struct strComparison {
-    bool operator () (const std::string& str1, const std::string& str2) const {
-        if (str1.length() == str2.length()) return str1 < str2;
-        return str1.length() < str2.length();
-    }
-};
-
-// Generating the infix of a string
-std::set<std::string, strComparison> infixesOf(const std::string& word) {
-    std::set<std::string, strComparison> ic;
-    for (int len = 0; len <= word.length(); ++len) {
-        for (int index = 0; index < word.length() - len + 1; ++index) {
-            ic.insert(word.substr(index, len));
-        }
-    }
-    return ic;
-}
-
-std::set<std::string, strComparison> generatingIC(const std::vector<std::string>& pos, const std::vector<std::string>& neg) {
-    // Generating infix-closure (ic) of the input strings
-    std::set<std::string, strComparison> ic = {};
-
-    for (const std::string& word : pos) {
-        std::set<std::string, strComparison> set1 = infixesOf(word);
-        ic.insert(set1.begin(), set1.end());
-    }
-    for (const std::string& word : neg) {
-        std::set<std::string, strComparison> set1 = infixesOf(word);
-        ic.insert(set1.begin(), set1.end());
-    }
-    return ic;
-}
-
 // constant memory needs to be global, only 64kb in size
 __constant__ uint64_t deviceData[64 * 128];
 
@@ -219,33 +186,16 @@ private:
     }
 };
 
-bool generatingGuideTable(GuideTable* guideTable, const std::set<std::string, strComparison>& ic)
+// The one-hot CSs of the splits of every word, from their indices in the guide table of the host
+bool generatingGuideTable(GuideTable* guideTable, const paresy_s::HostGuideTable& hostGuideTable)
 {
-    int alphabetSize = -1;
-    for (auto& word : ic) {
-        if (word.size() > 1) break;
-        alphabetSize++;
-    }
-
     std::vector<std::vector<CS>> gt;
 
-    for (auto& word : ic) {
+    for (int ix = 0; ix < hostGuideTable.ICsize; ++ix) {
         std::vector<CS> row;
-        for (int i = 1; i < word.length(); ++i) {
-
-            int index1 = 0;
-            for (auto& w : ic) {
-                if (w == word.substr(0, i)) break;
-                index1++;
-            }
-            int index2 = 0;
-            for (auto& w : ic) {
-                if (w == word.substr(i)) break;
-                index2++;
-            }
-
-            row.push_back(CS::one() << index1);
-            row.push_back(CS::one() << index2);
+        for (auto split = hostGuideTable.rowBegin(ix); split != hostGuideTable.rowEnd(ix); ++split) {
+            row.push_back(CS::one() << split->left);
+            row.push_back(CS::one() << split->right);
         }
 
         row.push_back(CS());
@@ -271,15 +221,20 @@ bool generatingGuideTable(GuideTable* guideTable, const std::set<std::string, st
         return false;
     }
 
-    new (guideTable) GuideTable(gt, alphabetSize);
+    new (guideTable) GuideTable(gt, hostGuideTable.alphabetSize);
     return true;
 }
 
+bool generatingGuideTable(GuideTable* guideTable, const std::set<std::string, strComparison>& ic)
+{
+    return generatingGuideTable(guideTable, paresy_s::HostGuideTable(ic));
+}
+
 // Generating of the guide table only once for the whole enumeration process
 bool generatingGuideTable(GuideTable& guideTable, CS& posBits, CS& negBits,
     const std::vector<std::string>& pos, const std::vector<std::string>& neg) {
 
-    std::set<std::string, strComparison> ic = generatingIC(pos, neg);
+    std::set<std::string, strComparison> ic = paresy_s::generatingIC(pos, neg);
 
     if (!generatingGuideTable(&guideTable, ic))
         return false;
@@ -299,27 +254,6 @@ bool generatingGuideTable(GuideTable& guideTable, CS& posBits, CS& negBits,
 
 // ============= operations =============
 
-enum class Opreation { Question = 0, Star = 1, Concatenate = 2, Or = 3, And = 4, Count = 5 };
-
-std::string to_string(Opreation op) {
-    switch (op)
-    {
-    case Opreation::Question:
-        return "Q";
-    case Opreation::Star:
-        return "S";
-    case Opreation::Concatenate:
-        return "C";
-    case Opreation::Or:
-        return "O";
-    case Opreation::And:
-        return "A";
-    default:
-        break;
-    }
-    return "";
-}
-
 __device__ inline CS processQuestion(const CS& cs) {
     return cs | CS::one();
 }
@@ -382,42 +316,6 @@ __device__ inline CS processAnd(const CS& left, const  CS& right) {
 
 // ============= Context =============
 
-class CostIntervals {
-public:
-    CostIntervals(const unsigned short maxCost) {
-        opCount = static_cast<int>(Opreation::Count);
-        startPoints = new int[(maxCost + 2) * opCount]();
-    }
-    ~CostIntervals() {
-        delete[] startPoints;
-    }
-    std::tuple<int, int> Interval(int cost, Opreation start = Opreation::Question, Opreation end = Opreation::And) const {
-        return std::make_tuple(this->start(cost, start), this->end(cost, end));
-    }
-    int& start(int cost, Opreation op) {
-        return startPoints[cost * opCount + static_cast<int>(op)];
-    }
-    int start(int cost, Opreation op) const {
-        return startPoints[cost * opCount + static_cast<int>(op)];
-    }
-    int& end(int cost, Opreation op) {
-        return startPoints[cost * opCount + static_cast<int>(op) + 1];
-    }
-    int end(int cost, Opreation op) const {
-        return startPoints[cost * opCount + static_cast<int>(op) + 1];
-    }
-    void indexToCost(int index, int& cost, Opreation& op) const {
-        int i = 0;
-        while (index >= startPoints[i]) { i++; }
-        i--;
-        cost = i / opCount;
-        op = static_cast<Opreation>(i % opCount);
-    }
-private:
-    int* startPoints;
-    int opCount;
-};
-
 struct DeviceHashSet
 {
     using hash_set_t = warpcore::HashSet<
@@ -447,7 +345,7 @@ private:
 };
 
 // Initialising the hashSets with empty, epsilon and alphabet before starting the enumeration
-__global__ void hashSetsInitialisation(DeviceHashSet d_visited, CS* d_langCache, int alphabetSize)
+__global__ void hashSetsInitialisation(DeviceHashSet d_visited, CacheView d_langCache, int alphabetSize)
 {
     // Adding empty to the hashSet
     d_visited.insert(0,0);
@@ -462,6 +360,52 @@ __global__ void hashSetsInitialisation(DeviceHashSet d_visited, CS* d_langCache,
     }
 }
 
+// ============= Language cache =============
+
+// Copying CSs between regions of the language caches, and to and from the CSs one after another on the host
+
+void copyCSs(paresy_s::PackedView<CS> dst, paresy_s::PackedView<CS> src, int N) {
+    checkCuda(cudaMemcpy(dst.data, src.data, N * sizeof(CS), cudaMemcpyDeviceToDevice));
+}
+
+void copyCSs(paresy_s::WordSlicedView<CS> dst, paresy_s::WordSlicedView<CS> src, int N) {
+    if (N == 0) return;
+    checkCuda(cudaMemcpy2D(dst.words, dst.stride * sizeof(uint64_t), src.words, src.stride * sizeof(uint64_t),
+        N * sizeof(uint64_t), CS::wordCount, cudaMemcpyDeviceToDevice));
+}
+
+void uploadCSs(paresy_s::PackedView<CS> dst, const CS* css, int N) {
+    checkCuda(cudaMemcpy(dst.data, css, N * sizeof(CS), cudaMemcpyHostToDevice));
+}
+
+void uploadCSs(paresy_s::WordSlicedView<CS> dst, const CS* css, int N) {
+    if (N == 0) return;
+    std::vector<uint64_t> words(static_cast<size_t>(N) * CS::wordCount);
+    for (int k = 0; k < CS::wordCount; ++k)
+        for (int i = 0; i < N; ++i) words[static_cast<size_t>(k) * N + i] = css[i].getWord(k);
+    checkCuda(cudaMemcpy2D(dst.words, dst.stride * sizeof(uint64_t), words.data(), N * sizeof(uint64_t),
+        N * sizeof(uint64_t), CS::wordCount, cudaMemcpyHostToDevice));
+}
+
+void downloadCSs(CS* css, paresy_s::PackedView<CS> src, int N) {
+    checkCuda(cudaMemcpy(css, src.data, N * sizeof(CS), cudaMemcpyDeviceToHost));
+}
+
+void downloadCSs(CS* css, paresy_s::WordSlicedView<CS> src, int N) {
+    if (N == 0) return;
+    std::vector<uint64_t> words(static_cast<size_t>(N) * CS::wordCount);
+    checkCuda(cudaMemcpy2D(words.data(), N * sizeof(uint64_t), src.words, src.stride * sizeof(uint64_t),
+        N * sizeof(uint64_t), CS::wordCount, cudaMemcpyDeviceToHost));
+    for (int k = 0; k < CS::wordCount; ++k)
+        for (int i = 0; i < N; ++i) css[i].setWord(k, words[static_cast<size_t>(k) * N + i]);
+}
+
+// A solution that a kernel has collected, the phase that has made it is found from its tid on the host
+struct DeviceSolution {
+    uint64_t high, low;
+    int tid, left, right;
+};
+
 class Context {
 public:
 
@@ -475,21 +419,32 @@ public:
     }
 
     Context(int cache_capacity, int temp_cache_capacity, CS posBits, CS negBits)
-        : cache_capacity(cache_capacity), temp_cache_capacity(temp_cache_capacity), posBits(posBits), negBits(negBits),
+        : cache_capacity(cache_capacity), temp_cache_capacity(temp_cache_capacity), posBits(posBits), negBits(negBits), solution(posBits, negBits),
         d_visited(cache_capacity * 2) {
 
         FinalREIdx = new int[1]; *FinalREIdx = -1;
 
         checkCuda(cudaMalloc(&d_FinalREIdx, sizeof(int)));
         checkCuda(cudaMemcpy(d_FinalREIdx, FinalREIdx, sizeof(int), cudaMemcpyHostToDevice));
-
-        checkCuda(cudaMalloc(&d_langCache, cache_capacity * sizeof(CS)));
-        checkCuda(cudaMalloc(&d_temp_langCache, temp_cache_capacity * sizeof(CS)));
+        checkCuda(cudaMalloc(&d_finalIndices, 2 * sizeof(int)));
+        checkCuda(cudaMalloc(&d_outCounts, maxBatchLaunches * sizeof(int)));
+        checkCuda(cudaMalloc(&d_solutions, paresy_s::SolutionSet::capacity * sizeof(DeviceSolution)));
+        checkCuda(cudaMalloc(&d_solutionCount, sizeof(int)));
+        checkCuda(cudaMemset(d_solutionCount, 0, sizeof(int)));
+
+        uint64_t* memory;
+        checkCuda(cudaMalloc(&memory, cache_capacity * sizeof(CS)));
+        d_langCache = CacheView(memory, cache_capacity);
+        checkCuda(cudaMalloc(&memory, temp_cache_capacity * sizeof(CS)));
+        d_temp_langCache = CacheView(memory, temp_cache_capacity);
         checkCuda(cudaMalloc(&d_leftIdx, cache_capacity * sizeof(int)));
         checkCuda(cudaMalloc(&d_rightIdx, cache_capacity * sizeof(int)));
         checkCuda(cudaMalloc(&d_temp_leftIdx, temp_cache_capacity * sizeof(int)));
         checkCuda(cudaMalloc(&d_temp_rightIdx, temp_cache_capacity * sizeof(int)));
 
+        streams.resize(phaseStreamCount);
+        for (auto& stream : streams) checkCuda(cudaStreamCreate(&stream));
+
         lastIdx = 0;
         isFound = false;
         allREs = 0;
@@ -501,39 +456,73 @@ public:
         delete[] FinalREIdx;
 
         checkCuda(cudaFree(d_FinalREIdx));
-        checkCuda(cudaFree(d_langCache));
-        checkCuda(cudaFree(d_temp_langCache));
+        checkCuda(cudaFree(d_finalIndices));
+        checkCuda(cudaFree(d_outCounts));
+        checkCuda(cudaFree(d_solutions));
+        checkCuda(cudaFree(d_solutionCount));
+        checkCuda(cudaFree(d_langCache.memory()));
+        checkCuda(cudaFree(d_temp_langCache.memory()));
         checkCuda(cudaFree(d_leftIdx));
         checkCuda(cudaFree(d_rightIdx));
         checkCuda(cudaFree(d_temp_leftIdx));
         checkCuda(cudaFree(d_temp_rightIdx));
+        if (d_extraAtoms) checkCuda(cudaFree(d_extraAtoms));
+
+        for (auto stream : streams) checkCuda(cudaStreamDestroy(stream));
     }
 
     class Device 
     {
     public:
-        Device(Context& context)
+        Device(Context& context, int launch, int tempOffset, int N)
             : d_langCache(context.d_langCache),
-            d_temp_langCache(context.d_temp_langCache),
             d_visited(context.d_visited),
-            d_temp_leftIdx(context.d_temp_leftIdx),
-            d_temp_rightIdx(context.d_temp_rightIdx),
             d_FinalREIdx(context.d_FinalREIdx),
+            d_finalIndices(context.d_finalIndices),
+            d_solutions(context.d_solutions),
+            d_solutionCount(context.d_solutionCount),
+            d_outCount(context.d_outCounts + launch),
             onTheFly(context.onTheFly),
-            posBits(context.posBits),
-            negBits(context.negBits)
+            solution(context.solution),
+            tempOffset(tempOffset)
         {
+            // The first launch of a batch writes straight into the language cache, the others into their
+            // region of the temp buffer, they are copied after the launches before them are stored
+            if (launch == 0) {
+                d_out = context.d_langCache + context.lastIdx;
+                d_outLeftIdx = context.d_leftIdx + context.lastIdx;
+                d_outRightIdx = context.d_rightIdx + context.lastIdx;
+                outCapacity = static_cast<int>(context.cache_capacity - context.lastIdx);
+            }
+            else {
+                d_out = context.d_temp_langCache + tempOffset;
+                d_outLeftIdx = context.d_temp_leftIdx + tempOffset;
+                d_outRightIdx = context.d_temp_rightIdx + tempOffset;
+                outCapacity = N;
+            }
         }
 
-        const CS* d_langCache;
-        CS* d_temp_langCache;
+        CacheView d_langCache;
         DeviceHashSet d_visited;
-        int* d_temp_leftIdx;
-        int* d_temp_rightIdx;
         int* d_FinalREIdx;
+        // The left and right indices of the solution
+        int* d_finalIndices;
+        // The solutions when they are collected, at most SolutionSet::capacity of them between two collections.
+        // They are distinct, the ones in "OnTheFly" mode go through the hash set too
+        DeviceSolution* d_solutions;
+        int* d_solutionCount;
+
+        // The new REs are written compacted, in the order of the slots that their warps claim
+        CacheView d_out;
+        int* d_outLeftIdx;
+        int* d_outRightIdx;
+        int* d_outCount;
+        int outCapacity;
 
         bool onTheFly;
-        CS posBits, negBits;
+        paresy_s::SolutionCheck<CS> solution;
+        // The start of the region of the temp buffer of this launch, the tid of a solution is reported in it
+        int tempOffset;
 
         __device__ inline void insert(const CS& CS, int tid, int ldx, int rdx = 0) {
             insert(CS, tid, ldx, rdx, warpcore::cg::tiled_partition<1>(warpcore::cg::this_thread_block()));
@@ -541,43 +530,86 @@ public:
 
         __device__ inline void insert(const CS& CS, int tid, int ldx, int rdx, const warpcore::cg::thread_block_tile<1>& group) {
 
-            if (onTheFly) {
+            tid += tempOffset;
 
-                if ((CS & posBits) == posBits && (~CS & negBits) == negBits) {
-                    *d_FinalREIdx = tid;
-                    d_temp_langCache[tid] = CS;
-                    d_temp_leftIdx[tid] = ldx;
-                    d_temp_rightIdx[tid] = rdx;
+            if (onTheFly) {
+                if (!solution(CS)) return;
+                // Many pairs make the same solution, the hash set keeps them from taking more than one slot of the buffer
+                if (paresy_s::SolutionSet::collecting) {
+                    auto [high, low] = CS.get128Hash();
+                    if (!d_visited.insert(high, low)) return;
                 }
+                setFinal(CS, tid, ldx, rdx);
+                return;
             }
-            else {
-                auto [high, low] = CS.get128Hash();
-                if (d_visited.insert(high, low)) {
-                    d_temp_langCache[tid] = CS;
-                    d_temp_leftIdx[tid] = ldx;
-                    d_temp_rightIdx[tid] = rdx;
-                    if ((CS & posBits) == posBits && (~CS & negBits) == negBits)
-                        atomicCAS(d_FinalREIdx, -1, tid);
+
+            auto [high, low] = CS.get128Hash();
+            bool isNew = d_visited.insert(high, low);
+            if (isNew && solution(CS)) setFinal(CS, tid, ldx, rdx);
+
+            // One atomic per group of converged lanes claims the slots of all of its new REs. The lanes that
+            // have diverged after setFinal are in a group of their own, so none of them is left out of the count
+            auto active = warpcore::cg::coalesced_threads();
+            unsigned ballot = active.ballot(isNew);
+            if (!ballot) return;
+
+            int rank = active.thread_rank();
+            int base = 0;
+            if (rank == 0) base = atomicAdd(d_outCount, __popc(ballot));
+            base = active.shfl(base, 0);
+
+            if (isNew) {
+                int slot = base + __popc(ballot & ((1u << rank) - 1));
+                // the ones past the end of a full language cache are dropped, like before the switch to OnTheFly
+                if (slot < outCapacity) {
+                    d_out.set(slot, CS);
+                    d_outLeftIdx[slot] = ldx;
+                    d_outRightIdx[slot] = rdx;
                 }
-                else {
-                    d_temp_langCache[tid] = CS::all();
-                    d_temp_leftIdx[tid] = -1;
-                    d_temp_rightIdx[tid] = -1;
+            }
+        }
+
+        // In "OnTheFly" mode only a solution matters, so the words of the operands with examples are checked first
+        template <class Op>
+        __device__ inline bool skip(int ldx, int rdx, Op op) const {
+            return onTheFly && !paresy_s::maybeSolution(d_langCache, ldx, rdx, solution, op);
+        }
+
+        // A collected solution is stored like the other REs, the first one ends the enumeration otherwise
+        __device__ inline void setFinal(const CS& CS, int tid, int ldx, int rdx) {
+            if (paresy_s::SolutionSet::collecting) {
+                int slot = atomicAdd(d_solutionCount, 1);
+                if (slot < paresy_s::SolutionSet::capacity) {
+                    auto [high, low] = CS.get128Hash();
+                    d_solutions[slot] = { high, low, tid, ldx, rdx };
                 }
+                return;
+            }
+            if (atomicCAS(d_FinalREIdx, -1, tid) == -1) {
+                d_finalIndices[0] = ldx;
+                d_finalIndices[1] = rdx;
             }
         }
     };
 
-    Device deviceContext() {
-        return Device(*this);
+    // A launch of a batch, its tids start at tempOffset in the temp buffer and there are N of them
+    Device deviceContext(int launch = 0, int tempOffset = 0, int N = 0) {
+        return Device(*this, launch, tempOffset, N);
+    }
+
+    // Setting the counters of the compacted outputs of the next launches to zero
+    void resetOutputs(int launches) {
+        checkCuda(cudaMemset(d_outCounts, 0, launches * sizeof(int)));
     }
 
     // Checking empty, epsilon, and the alphabet
-    bool intialCheck(int alphaCost, const std::vector<std::string>& pos, const std::vector<std::string>& neg, std::string& RE)
+    bool intialCheck(int alphaCost, const std::vector<std::string>& pos, const std::vector<std::string>& neg,
+        const paresy_s::AlphabetClasses& classes, std::string& RE)
     {
         // Initialisation of the alphabet
         for (auto& word : pos) for (auto ch : word) alphabet.insert(ch);
         for (auto& word : neg) for (auto ch : word) alphabet.insert(ch);
+        for (auto ch : alphabet) atoms.push_back(classes.expand(ch));
 
         LOG_OP((*this), alphaCost, std::string("Alpha"), static_cast<int>(alphabet.size()) + 2)
 
@@ -601,13 +633,13 @@ public:
             allREs++;
 
             std::string s(1, *next(alphabet.begin(), i));
-            if ((pos.size() == 1) && (pos.at(0) == s)) { RE = s; return true; }
+            if ((pos.size() == 1) && (pos.at(0) == s)) { RE = atoms[i]; return true; }
 
             idx <<= 1;
             lastIdx++;
         }
 
-        checkCuda(cudaMemcpy(d_langCache, langCache, alphabetSize * sizeof(CS), cudaMemcpyHostToDevice));
+        uploadCSs(d_langCache, langCache, alphabetSize);
         hashSetsInitialisation<<<1, 1>>>(d_visited, d_langCache, alphabetSize);
 
         delete[] langCache;
@@ -615,67 +647,150 @@ public:
         return false;
     }
 
-    bool syncAndCheck(int REs) {
+    // For a single launch, its solutions are made by op at cost
+    bool syncAndCheck(int REs, int cost, Opreation op) {
+        if (checkFound(REs) || collectSolutions(cost, [op](int) { return op; })) return true;
+        if (!onTheFly) storeUniqueREs(0, outputCounts(1)[0]);
+        return false;
+    }
+
+    // Waiting for the launches and checking if any of them has found the solution
+    bool checkFound(int REs) {
         checkCuda(cudaMemcpy(FinalREIdx, d_FinalREIdx, sizeof(int), cudaMemcpyDeviceToHost));
         allREs += REs;
         if (*FinalREIdx != -1) { isFound = true; return true; }
-        if (!onTheFly) storeUniqueREs(REs);
         return false;
     }
 
+    // Moving the solutions of the last launches into the set, phase(tid) is the operation that has made the one
+    // at tid. The buffer is bounded, so a full one is checked after every batch. Returns true once the set is full
+    template <class Phase>
+    bool collectSolutions(int cost, Phase phase) {
+        if (!paresy_s::SolutionSet::collecting) return false;
+
+        int count;
+        checkCuda(cudaMemcpy(&count, d_solutionCount, sizeof(int), cudaMemcpyDeviceToHost));
+        if (count == 0) return false;
+
+        std::vector<DeviceSolution> found(std::min(count, paresy_s::SolutionSet::capacity));
+        checkCuda(cudaMemcpy(found.data(), d_solutions, found.size() * sizeof(DeviceSolution), cudaMemcpyDeviceToHost));
+        checkCuda(cudaMemset(d_solutionCount, 0, sizeof(int)));
+
+        for (auto& solution : found) solutions.add(solution.high, solution.low, { solution.left, solution.right, cost, phase(solution.tid) });
+        isFound = solutions.full();
+        return isFound;
+    }
+
+    // Keeping the character classes and the seeds on the device for their launches
+    void setExtraAtoms(const std::vector<CS>& atoms) {
+        checkCuda(cudaMalloc(&d_extraAtoms, atoms.size() * sizeof(CS)));
+        checkCuda(cudaMemcpy(d_extraAtoms, atoms.data(), atoms.size() * sizeof(CS), cudaMemcpyHostToDevice));
+    }
+
     void printLangCahce() {
         auto cache = new CS[lastIdx];
-        checkCuda(cudaMemcpy(cache, d_langCache, sizeof(CS) * lastIdx, cudaMemcpyDeviceToHost));
+        downloadCSs(cache, d_langCache, static_cast<int>(lastIdx));
         for (size_t i = 0; i < lastIdx; i++) { cache[i].print(); }
         delete[] cache;
     }
 
-    void storeUniqueREs(int N) {
-        thrust::device_ptr<CS> new_end_ptr;
-        thrust::device_ptr<CS> d_langCache_ptr(d_langCache + lastIdx);
-        thrust::device_ptr<CS> d_temp_langCache_ptr(d_temp_langCache);
-        thrust::device_ptr<int> d_leftIdx_ptr(d_leftIdx + lastIdx);
-        thrust::device_ptr<int> d_rightIdx_ptr(d_rightIdx + lastIdx);
-        thrust::device_ptr<int> d_temp_leftIdx_ptr(d_temp_leftIdx);
-        thrust::device_ptr<int> d_temp_rightIdx_ptr(d_temp_rightIdx);
-
-        new_end_ptr = // end of d_temp_langCache
-            thrust::remove(d_temp_langCache_ptr, d_temp_langCache_ptr + N, CS::all());
-        thrust::remove(d_temp_leftIdx_ptr, d_temp_leftIdx_ptr + N, -1);
-        thrust::remove(d_temp_rightIdx_ptr, d_temp_rightIdx_ptr + N, -1);
+    // Storing the new REs that the launch number `launch` of the batch has written compacted.
+    // The ones of the first launch are in place already, the others are copied from their region of the temp buffer
+    void storeUniqueREs(int launch, int count, int tempOffset = 0) {
 
         // It stores all (or a part of) unique CSs until language cahce gets full
         // If language cache gets full, it makes onTheFly mode on
-        int numberOfNewUniqueREs = static_cast<int>(new_end_ptr - d_temp_langCache_ptr);
-        if (lastIdx + numberOfNewUniqueREs > cache_capacity) {
+        int N = count;
+        if (lastIdx + count > cache_capacity) {
             N = cache_capacity - lastIdx;
             onTheFly = true;
 #if LOG_LEVEL >= 2
             printf("==== switch to \"OnTheFly\" ====\n");
 #endif
         }
-        else N = numberOfNewUniqueREs;
 
-        thrust::copy_n(d_temp_langCache_ptr, N, d_langCache_ptr);
-        thrust::copy_n(d_temp_leftIdx_ptr, N, d_leftIdx_ptr);
-        thrust::copy_n(d_temp_rightIdx_ptr, N, d_rightIdx_ptr);
+        if (launch > 0) {
+            copyCSs(d_langCache + lastIdx, d_temp_langCache + tempOffset, N);
+            checkCuda(cudaMemcpy(d_leftIdx + lastIdx, d_temp_leftIdx + tempOffset, N * sizeof(int), cudaMemcpyDeviceToDevice));
+            checkCuda(cudaMemcpy(d_rightIdx + lastIdx, d_temp_rightIdx + tempOffset, N * sizeof(int), cudaMemcpyDeviceToDevice));
+        }
 
         lastIdx += N;
     }
 
+    // The number of new REs that each launch of the batch has written
+    std::vector<int> outputCounts(int launches) {
+        std::vector<int> counts(launches);
+        checkCuda(cudaMemcpy(counts.data(), d_outCounts, launches * sizeof(int), cudaMemcpyDeviceToHost));
+        return counts;
+    }
+
+#ifdef MEET_IN_THE_MIDDLE
+    // Prepares the projection of the language cache, only when both sides fit in a word
+    bool initProjections(int ICsize) {
+        for (int i = 0; i < ICsize; ++i) {
+            if (posBits.test(i)) posIndices.push_back(i);
+            if (negBits.test(i)) negIndices.push_back(i);
+        }
+        return posIndices.size() <= 64 && negIndices.size() <= 64;
+    }
+
+    // Projecting the REs that are stored since the last call
+    void updateProjections() {
+        const int chunkSize = 1 << 20;
+        auto* cache = new CS[chunkSize];
+
+        while (projections.size() < lastIdx) {
+            int from = static_cast<int>(projections.size());
+            int N = std::min(chunkSize, static_cast<int>(lastIdx) - from);
+            downloadCSs(cache, d_langCache + from, N);
+            for (int i = 0; i < N; ++i)
+                projections.push_back(paresy_s::projectCS(cache[i], posIndices.data(), static_cast<int>(posIndices.size()),
+                    negIndices.data(), static_cast<int>(negIndices.size())));
+        }
+
+        delete[] cache;
+    }
+
+    // Storing a solution that is found on the host like the kernels do
+    void setFinalRE(int ldx, int rdx) {
+        int indices[2] = { ldx, rdx };
+        checkCuda(cudaMemcpy(d_finalIndices, indices, 2 * sizeof(int), cudaMemcpyHostToDevice));
+        *FinalREIdx = 0;
+        checkCuda(cudaMemcpy(d_FinalREIdx, FinalREIdx, sizeof(int), cudaMemcpyHostToDevice));
+        isFound = true;
+    }
+
+    std::vector<int> posIndices, negIndices;
+    std::vector<paresy_s::Projection> projections;
+#endif
+
     std::set<char> alphabet;
+    // The string of every atom at the start of the language cache
+    std::vector<std::string> atoms;
+    // The strings of the character classes and the seeds, their provenance is -3 - (index)
+    std::vector<std::string> classAtoms;
 
     int cache_capacity;
     int temp_cache_capacity;
 
-    CS* d_langCache;
-    CS* d_temp_langCache;
+    // The layout is chosen by WORD_SLICED_CACHE
+    CacheView d_langCache;
+    CacheView d_temp_langCache;
+    CS* d_extraAtoms = nullptr;
     DeviceHashSet d_visited;
     int* d_leftIdx;
     int* d_rightIdx;
     int* d_temp_leftIdx;
     int* d_temp_rightIdx;
     int* d_FinalREIdx;
+    int* d_finalIndices;
+    // The number of new REs of every launch of a batch
+    int* d_outCounts;
+    DeviceSolution* d_solutions;
+    int* d_solutionCount;
+    // The solutions on the host when they are collected
+    paresy_s::SolutionSet solutions;
 
     uint64_t allREs;
     // Index of the last free position in the language cache
@@ -684,6 +799,14 @@ public:
     bool onTheFly;
     int* FinalREIdx;
     CS posBits, negBits;
+    // The solution check on the words with examples, the kernels get a copy of it
+    paresy_s::SolutionCheck<CS> solution;
+
+    // The launches of the phases of a cost level run side by side on these streams
+    static constexpr int phaseStreamCount = 4;
+    // The most launches in a batch, each one has its own output counter
+    static constexpr int maxBatchLaunches = 256;
+    std::vector<cudaStream_t> streams;
 };
 
 __global__ void QuestionMark(Pair<int> interval, Context::Device context)
@@ -756,9 +879,10 @@ __global__ void Or(Pair<int> lInterval, Pair<int> rInterval, Context::Device con
     if (tid < (lInterval.right - lInterval.left) * (rInterval.right - rInterval.left)) {
 
         int ldx = lInterval.left + tid / (rInterval.right - rInterval.left);
-        CS lCS = context.d_langCache[ldx];
-
         int rdx = rInterval.left + tid % (rInterval.right - rInterval.left);
+        if (context.skip(ldx, rdx, paresy_s::OrOp())) return;
+
+        CS lCS = context.d_langCache[ldx];
         CS rCS = context.d_langCache[rdx];
 
         auto CS = processOr(lCS, rCS);
@@ -774,9 +898,10 @@ __global__ void And(Pair<int> lInterval, Pair<int> rInterval, Context::Device co
     if (tid < (lInterval.right - lInterval.left) * (rInterval.right - rInterval.left)) {
 
         int ldx = lInterval.left + tid / (rInterval.right - rInterval.left);
-        CS lCS = context.d_langCache[ldx];
-
         int rdx = rInterval.left + tid % (rInterval.right - rInterval.left);
+        if (context.skip(ldx, rdx, paresy_s::AndOp())) return;
+
+        CS lCS = context.d_langCache[ldx];
         CS rCS = context.d_langCache[rdx];
 
         auto CS = processAnd(lCS, rCS);
@@ -785,177 +910,287 @@ __global__ void And(Pair<int> lInterval, Pair<int> rInterval, Context::Device co
     }
 }
 
-// ============= To String =============
-
-// Finding the left and right indices that makes the final RE to bring to the host later
-__global__ void generateResIndices(
-    const int index,
-    const int alphabetSize,
-    const int* d_leftIdx,
-    const int* d_rightIdx,
-    int* d_FinalREIdx)
+// Or of the pairs x < y of one interval, from the pair number firstPair on
+__global__ void OrTriangle(Pair<int> interval, uint64_t firstPair, int N, Context::Device context)
 {
+    const int tid = blockDim.x * blockIdx.x + threadIdx.x;
 
-    int resIdx = 0;
-    while (d_FinalREIdx[resIdx] != -1) resIdx++;
-    int queue[600];
-    queue[0] = index;
-    int head = 0;
-    int tail = 1;
-    while (head < tail) {
-        int re = queue[head];
-        int l = d_leftIdx[re];
-        int r = d_rightIdx[re];
-        d_FinalREIdx[resIdx++] = re;
-        d_FinalREIdx[resIdx++] = l;
-        d_FinalREIdx[resIdx++] = r;
-        if (l >= alphabetSize) queue[tail++] = l;
-        if (r >= alphabetSize) queue[tail++] = r;
-        head++;
-    }
+    if (tid < N) {
 
-}
+        auto [x, y] = paresy_s::triangularIndex(firstPair + tid);
+
+        int ldx = interval.left + x;
+        int rdx = interval.left + y;
+        if (context.skip(ldx, rdx, paresy_s::OrOp())) return;
+
+        CS lCS = context.d_langCache[ldx];
+        CS rCS = context.d_langCache[rdx];
+
+        auto CS = processOr(lCS, rCS);
 
-// Adding parentheses if needed
-std::string bracket(std::string s) {
-    int p = 0;
-    for (int i = 0; i < s.length(); i++) {
-        if (s[i] == '(') p++;
-        else if (s[i] == ')') p--;
-        else if ((s[i] == '+' || s[i] == '&') && p <= 0) return "(" + s + ")";
+        context.insert(CS, tid, ldx, rdx);
     }
-    return s;
 }
 
-// Generating the final RE string recursively
-// When all the left and right indices are ready in the host
-std::string toString(
-    int index,
-    std::map<int, std::pair<int, int>>& indicesMap,
-    const std::set<char>& alphabet,
-    const CostIntervals& intervals)
+// And of the pairs x < y of one interval, from the pair number firstPair on
+__global__ void AndTriangle(Pair<int> interval, uint64_t firstPair, int N, Context::Device context)
 {
+    const int tid = blockDim.x * blockIdx.x + threadIdx.x;
 
-    if (index == -2) return "eps"; // Epsilon
-    if (index == -1) return "Error";
-    if (index < alphabet.size()) {
-        std::string s(1, *next(alphabet.begin(), index));
-        return s;
-    }
+    if (tid < N) {
 
-    int cost; Opreation op;
-    intervals.indexToCost(index, cost, op);
+        auto [x, y] = paresy_s::triangularIndex(firstPair + tid);
 
-    if (op == Opreation::Question) {
-        std::string res = toString(indicesMap[index].first, indicesMap, alphabet, intervals);
-        if (res.length() > 1) return "(" + res + ")?";
-        return res + "?";
-    }
+        int ldx = interval.left + x;
+        int rdx = interval.left + y;
+        if (context.skip(ldx, rdx, paresy_s::AndOp())) return;
 
-    if (op == Opreation::Star) {
-        std::string res = toString(indicesMap[index].first, indicesMap, alphabet, intervals);
-        if (res.length() > 1) return "(" + res + ")*";
-        return res + "*";
-    }
+        CS lCS = context.d_langCache[ldx];
+        CS rCS = context.d_langCache[rdx];
 
-    if (op == Opreation::Concatenate) {
-        std::string left = toString(indicesMap[index].first, indicesMap, alphabet, intervals);
-        std::string right = toString(indicesMap[index].second, indicesMap, alphabet, intervals);
-        return bracket(left) + bracket(right);
+        auto CS = processAnd(lCS, rCS);
+
+        context.insert(CS, tid, ldx, rdx);
     }
+}
 
-    if (op == Opreation::Or)
-    {
-        std::string left = toString(indicesMap[index].first, indicesMap, alphabet, intervals);
-        std::string right = toString(indicesMap[index].second, indicesMap, alphabet, intervals);
-        return left + "+" + right;
+// The character classes and the seeds of a level, from first on
+__global__ void Atoms(const CS* d_atoms, int first, int count, Context::Device context)
+{
+    const int tid = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if (tid < count) {
+        context.insert(d_atoms[first + tid], tid, -3 - (first + tid), -3 - (first + tid));
     }
+}
 
-    std::string left = toString(indicesMap[index].first, indicesMap, alphabet, intervals);
-    std::string right = toString(indicesMap[index].second, indicesMap, alphabet, intervals);
-    return left + "&" + right;
+// Inserting the character classes and the seeds as atoms, like any other RE they go through the uniqueness check
+bool seedAtoms(Context& context, Pair<int> level, int cost)
+{
+    for (auto chunk : paresy_s::splitInterval(level.left, level.right, context.temp_cache_capacity)) {
+        int N = chunk.right - chunk.left;
+        context.resetOutputs(1);
+        Atoms<<<(N + 127) / 128, 128>>>(context.d_extraAtoms, chunk.left, N, context.deviceContext());
+        checkCuda(cudaGetLastError());
+        if (context.syncAndCheck(N, cost, Opreation::Concatenate)) return true;
+    }
+    return false;
 }
 
-// Bringing the left and right indices of the RE from device to host
-std::string REtoString(const Context& context,const CostIntervals& intervals)
+// ============= Phases =============
+
+// A kernel launch of one phase of a cost level, its N candidates take at most one position each in the temp buffer
+struct DeviceLaunch {
+    Opreation op;
+    int N;
+    std::function<void(Context::Device, cudaStream_t)> launch;
+    // The pairs of Or and And, they are skipped once the cache is full if the lookups have covered them
+    bool pairs;
+};
+
+enum class LaunchStatus { Done, Found, TimeOut };
+
+// Running the launches of a cost level. The phases only read the cheaper levels, so as many launches as fit
+// in the temp buffer run at once on their own streams and regions, and small phases don't leave the GPU idle.
+// The regions are stored in the order of the launches like running them one after another, so the sub-intervals
+// of the level are still in the order of the operations. The first launch of a batch writes its new REs into the
+// cache directly, the others are copied from the temp buffer. On a solution, the end of its phase is set to INT_MAX
+LaunchStatus runLevel(Context& context, CostIntervals& intervals, int cost, int lastReadCost, const std::vector<DeviceLaunch>& launches, bool skipPairs,
+    std::chrono::steady_clock::time_point startTime, double maxTime)
 {
-    auto* LIdx = new int[1];
-    auto* RIdx = new int[1];
+    // The pairs are only needed for their REs when they aren't stored, or nothing reads this level
+    auto skipped = [&](const DeviceLaunch& launch) { return launch.pairs && skipPairs && (context.onTheFly || cost > lastReadCost); };
 
-    checkCuda(cudaMemcpy(LIdx, context.d_temp_leftIdx + *context.FinalREIdx, sizeof(int), cudaMemcpyDeviceToHost));
-    checkCuda(cudaMemcpy(RIdx, context.d_temp_rightIdx + *context.FinalREIdx, sizeof(int), cudaMemcpyDeviceToHost));
+    int phase = static_cast<int>(Opreation::Question);
+    auto closePhases = [&](Opreation op) {
+        for (; phase < static_cast<int>(op); ++phase) intervals.end(cost, static_cast<Opreation>(phase)) = context.lastIdx;
+    };
 
-    auto alphabetSize = static_cast<int> (context.alphabet.size());
+    std::vector<Pair<int>> batch; // (launch, offset in the temp buffer)
+    size_t next = 0;
 
-    int* d_resIndices;
-    checkCuda(cudaMalloc(&d_resIndices, 600 * sizeof(int)));
+    while (next < launches.size()) {
+
+        batch.clear();
+        int used = 0;
+        for (; next < launches.size() && batch.size() < Context::maxBatchLaunches
+            && used + launches[next].N <= context.temp_cache_capacity; ++next) {
+            if (skipped(launches[next])) continue;
+            batch.push_back({ static_cast<int>(next), used });
+            used += launches[next].N;
+        }
+        if (batch.empty()) {
+            // only the skipped launches were left, the launches are split to fit the temp buffer when they are made
+            assert(next == launches.size());
+            break;
+        }
+
+        context.resetOutputs(static_cast<int>(batch.size()));
+        for (size_t k = 0; k < batch.size(); ++k) {
+            auto [l, offset] = batch[k];
+            launches[l].launch(context.deviceContext(static_cast<int>(k), offset, launches[l].N), context.streams[k % context.streams.size()]);
+        }
+        checkCuda(cudaGetLastError());
+        checkCuda(cudaDeviceSynchronize());
+
+        if (context.checkFound(used)) {
+            for (auto [l, offset] : batch) {
+                if (*context.FinalREIdx < offset + launches[l].N) {
+                    closePhases(launches[l].op);
+                    intervals.setFinal(cost, launches[l].op);
+                    break;
+                }
+            }
+            return LaunchStatus::Found;
+        }
+
+        auto phaseOf = [&](int tid) {
+            for (auto [l, offset] : batch) if (tid < offset + launches[l].N) return launches[l].op;
+            return launches[batch.back().left].op;
+        };
+        if (context.collectSolutions(cost, phaseOf)) return LaunchStatus::Found;
+
+        std::vector<int> counts = context.outputCounts(static_cast<int>(batch.size()));
+        for (size_t k = 0; k < batch.size(); ++k) {
+            auto [l, offset] = batch[k];
+            closePhases(launches[l].op);
+            if (!context.onTheFly) context.storeUniqueREs(static_cast<int>(k), counts[k], offset);
+        }
+
+        if (checkTime(startTime, maxTime)) return LaunchStatus::TimeOut;
+    }
+
+    closePhases(Opreation::Count);
+    return LaunchStatus::Done;
+}
+
+// ============= To String =============
 
-    thrust::device_ptr<int> d_resIndices_ptr(d_resIndices);
-    thrust::fill(d_resIndices_ptr, d_resIndices_ptr + 600, -1);
+// The left and right indices of count REs, into d_indices[count, 2 * count) and d_indices[2 * count, 3 * count)
+__global__ void gatherIndices(int* d_indices, int count, const int* d_leftIdx, const int* d_rightIdx)
+{
+    const int tid = blockDim.x * blockIdx.x + threadIdx.x;
 
-    if (*LIdx >= alphabetSize) generateResIndices <<<1, 1 >>> (*LIdx, alphabetSize, context.d_leftIdx, context.d_rightIdx, d_resIndices);
-    if (*RIdx >= alphabetSize) generateResIndices <<<1, 1 >>> (*RIdx, alphabetSize, context.d_leftIdx, context.d_rightIdx, d_resIndices);
+    if (tid < count) {
+        int re = d_indices[tid];
+        d_indices[count + tid] = d_leftIdx[re];
+        d_indices[2 * count + tid] = d_rightIdx[re];
+    }
+}
 
-    int resIndices[600];
-    checkCuda(cudaMemcpy(resIndices, d_resIndices, 600 * sizeof(int), cudaMemcpyDeviceToHost));
+// Bringing the left and right indices of one depth of the solutions from device to host
+struct IndexFetch {
+    const Context& context;
 
-    std::map<int, std::pair<int, int>> indicesMap;
+    void operator()(const std::vector<int>& indices, std::vector<int>& left, std::vector<int>& right) const {
+        auto count = static_cast<int>(indices.size());
+        std::vector<int> buffer(3 * indices.size());
 
-    indicesMap.insert(std::make_pair(INT_MAX - 1, std::make_pair(*LIdx, *RIdx)));
+        int* d_indices;
+        checkCuda(cudaMalloc(&d_indices, buffer.size() * sizeof(int)));
+        checkCuda(cudaMemcpy(d_indices, indices.data(), count * sizeof(int), cudaMemcpyHostToDevice));
+        gatherIndices<<<(count + 127) / 128, 128>>>(d_indices, count, context.d_leftIdx, context.d_rightIdx);
+        checkCuda(cudaMemcpy(buffer.data(), d_indices, buffer.size() * sizeof(int), cudaMemcpyDeviceToHost));
+        cudaFree(d_indices);
 
-    int i = 0;
-    while (resIndices[i] != -1 && i + 2 < 600) {
-        int re = resIndices[i];
-        int l = resIndices[i + 1];
-        int r = resIndices[i + 2];
-        indicesMap.insert(std::make_pair(re, std::make_pair(l, r)));
-        i += 3;
+        std::copy_n(buffer.begin() + count, count, left.begin());
+        std::copy_n(buffer.begin() + 2 * count, count, right.begin());
     }
+};
 
-    if (i + 2 >= 600) return "Size of the output is too big";
+std::string REtoString(const Context& context,const CostIntervals& intervals)
+{
+    int finalIndices[2];
+    checkCuda(cudaMemcpy(finalIndices, context.d_finalIndices, 2 * sizeof(int), cudaMemcpyDeviceToHost));
 
-    cudaFree(d_resIndices);
+    auto alphabetSize = static_cast<int> (context.alphabet.size());
+    paresy_s::Provenance provenance({ { finalIndices[0], finalIndices[1] } }, alphabetSize, IndexFetch{ context });
+    return paresy_s::toString(paresy_s::Provenance::finalIndex, provenance, context.atoms, context.classAtoms, intervals);
+}
 
-    return toString(INT_MAX - 1, indicesMap, context.alphabet, intervals);
+// The result of the collected solutions, all of them are brought to the host at once. They are made of
+// the levels that are cheaper than cost, the start points after them are set like after a single solution
+paresy_s::Result solutionsResult(const Context& context, CostIntervals& intervals, int cost, int ICsize)
+{
+    intervals.setFinal(cost - 1, Opreation::And);
+
+    std::vector<Pair<int>> roots;
+    for (auto& found : context.solutions.all()) roots.push_back({ found.left, found.right });
+    paresy_s::Provenance provenance(roots, static_cast<int>(context.alphabet.size()), IndexFetch{ context });
+
+    auto solutions = paresy_s::toStrings(context.solutions.all(), provenance, context.atoms, context.classAtoms, intervals);
+    paresy_s::Result result(solutions.front().RE, solutions.front().REcost, context.allREs, ICsize);
+    result.solutions = std::move(solutions);
+    return result;
 }
 
 // ============= REI =============
 
-struct Costs
+#ifdef MEET_IN_THE_MIDDLE
+// Looking for a final A+B or A&B of this cost on the host, a partner of every A is looked up
+// in the projection index of the other interval instead of checking all the pairs
+bool meetInTheMiddle(Context& context, const CostIntervals& intervals, const Costs& costs, int cost, Opreation& op)
 {
-    int alpha;
-    int question;
-    int star;
-    int concat;
-    int alternation; //or
-    int intersection;
-    Costs(const unsigned short* costFun) {
-        alpha = costFun[0];
-        question = costFun[1];
-        star = costFun[2];
-        concat = costFun[3];
-        alternation = costFun[4];
-        intersection = costFun[5];
+    context.updateProjections();
+
+    auto posCount = static_cast<int>(context.posIndices.size());
+    auto negCount = static_cast<int>(context.negIndices.size());
+
+    for (int i = costs.alpha; 2 * i <= cost - costs.alternation; ++i) {
+
+        auto [lstart, lend] = intervals.Interval(i);
+        auto [rstart, rend] = intervals.Interval(cost - i - costs.alternation);
+        LOG_OP(context, cost, std::string("Or lookup"), (lend - lstart) + (rend - rstart))
+
+        auto found = paresy_s::findAlternation(context.projections.data(), Pair<int>(lstart, lend), Pair<int>(rstart, rend), posCount);
+        if (found.left != -1) { context.setFinalRE(found.left, found.right); op = Opreation::Or; return true; }
     }
-};
 
-bool checkTime(std::chrono::steady_clock::time_point startTime, double maxTime) {
-    auto duration = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - startTime).count();
-    return duration >= maxTime;
+    for (int i = costs.alpha; 2 * i <= cost - costs.intersection; ++i) {
+
+        auto [lstart, lend] = intervals.Interval(i);
+        auto [rstart, rend] = intervals.Interval(cost - i - costs.intersection);
+        LOG_OP(context, cost, std::string("And lookup"), (lend - lstart) + (rend - rstart))
+
+        auto found = paresy_s::findIntersection(context.projections.data(), Pair<int>(lstart, lend), Pair<int>(rstart, rend), posCount, negCount);
+        if (found.left != -1) { context.setFinalRE(found.left, found.right); op = Opreation::And; return true; }
+    }
+
+    return false;
 }
+#endif
+
+// The guide table of the examples on the device. It doesn't depend on the cost function, so the runs of a batch share it
+struct DeviceExamples {
+    DeviceExamples(const std::vector<std::string>& pos, const std::vector<std::string>& neg)
+    { fits = generatingGuideTable(guideTable, posBits, negBits, pos, neg); }
+
+    // An infix-closure that the host has made already
+    DeviceExamples(const paresy_s::HostExamples& examples) : posBits(examples.posBits), negBits(examples.negBits)
+    { fits = examples.fits && generatingGuideTable(&guideTable, examples.guideTable); }
+
+    GuideTable guideTable;
+    CS posBits{}, negBits{};
+    // The infix-closure fits in a CS
+    bool fits;
+};
 
-paresy_s::Result paresy_s::REI(const unsigned short* costFun, const unsigned short maxCost, const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime) {
+paresy_s::Result enumerate(DeviceExamples& examples, const unsigned short* costFun, const unsigned short maxCost,
+    const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime, const paresy_s::AlphabetClasses& classes,
+    const std::vector<paresy_s::Seed>& seeds = {}) {
 
     auto startTime = std::chrono::steady_clock::now();
 
     Costs costs(costFun);
 
-    GuideTable guideTable;
-    CS posBits{}, negBits{};
-    if (!generatingGuideTable(guideTable, posBits, negBits, pos, neg))
+    if (!examples.fits)
     { return paresy_s::Result("not_found", 0, 0, 0); }
 
-    uint64_t available_memory = (getFreeMemory() * 4) / 5; // 80% for the free memory
+    GuideTable& guideTable = examples.guideTable;
+    const CS& posBits = examples.posBits;
+    const CS& negBits = examples.negBits;
+
+    uint64_t available_memory = (getFreeMemory() * 4) / 5 / paresy_s::ResourceShare::parts(); // 80% for the free memory, the part of this leaf of it
     auto [ langCacheCapacity, temp_langCacheCapacity] = Context::getCacheCapacity(available_memory);
 
 #if LOG_LEVEL >= 2
@@ -968,13 +1203,36 @@ paresy_s::Result paresy_s::REI(const unsigned short* costFun, const unsigned sho
 
     std::string RE;
 
-    if (context.intialCheck(costs.alpha, pos, neg, RE)) return paresy_s::Result(RE, 0, context.allREs, guideTable.ICsize);
+    if (context.intialCheck(costs.alpha, pos, neg, classes, RE)) return paresy_s::Result(RE, 0, context.allREs, guideTable.ICsize);
+
+    // The classes and the seeds are seeded at their cost level next to the results of concatenation, like the alphabet
+    paresy_s::ExtraAtoms atoms(costs, maxCost, pos, neg, context.alphabet, seeds);
+    context.classAtoms = atoms.strings;
+    if (!atoms.empty()) context.setExtraAtoms(atoms.css);
+
+    auto alphaAtoms = atoms.level(costs.alpha);
+    if (alphaAtoms.left < alphaAtoms.right) {
+        LOG_OP(context, costs.alpha, std::string("Atoms"), alphaAtoms.right - alphaAtoms.left)
+        if (seedAtoms(context, alphaAtoms, costs.alpha) && !paresy_s::SolutionSet::collecting) {
+            intervals.setFinal(costs.alpha, Opreation::Concatenate);
+            return paresy_s::Result(REtoString(context, intervals), costs.alpha, context.allREs, guideTable.ICsize);
+        }
+        if (context.solutions.done(costs.alpha)) return solutionsResult(context, intervals, costs.alpha, guideTable.ICsize);
+    }
 
     intervals.end(costs.alpha, Opreation::Concatenate) = context.lastIdx;
     intervals.end(costs.alpha, Opreation::Or) = context.lastIdx;
     intervals.end(costs.alpha, Opreation::And) = context.lastIdx;
 
     int thread_count = 128;
+    std::vector<DeviceLaunch> launches;
+
+#ifdef MEET_IN_THE_MIDDLE
+    // A lookup finds a single solution, it can't collect them
+    bool useMeetInTheMiddle = !paresy_s::SolutionSet::collecting && context.initProjections(guideTable.ICsize);
+#endif
+    // Set when the lookups have covered every pair of Or and And in this cost
+    bool pairsLookedUp = false;
 
     int shortageCost = -1; bool lastRound = false;
     bool useQuestionOverOr = costs.alpha + costs.alternation >= costs.question;
@@ -988,7 +1246,21 @@ paresy_s::Result paresy_s::REI(const unsigned short* costFun, const unsigned sho
             int dif = cost - shortageCost;
             if (dif == costs.question || dif == costs.star || dif == costs.alpha + costs.concat || dif == costs.alpha + costs.alternation || dif == costs.alpha + costs.intersection) lastRound = true;
         }
+
+#ifdef MEET_IN_THE_MIDDLE
+        // Or and And of this cost only use the previous costs, so they are ready before the other operations
+        if (useMeetInTheMiddle) {
+            Opreation op;
+            if (meetInTheMiddle(context, intervals, costs, cost, op)) {
+                intervals.setFinal(cost, op); goto exitEnumeration;
+            }
+            pairsLookedUp = true;
+            if (checkTime(startTime, maxTime)) { goto exitEnumeration; }
+        }
+#endif
         
+        launches.clear();
+
         // Question mark
         if (cost >= costs.alpha + costs.question && useQuestionOverOr) {
             // ignore results from (*) and (?)
@@ -998,16 +1270,11 @@ paresy_s::Result paresy_s::REI(const unsigned short* costFun, const unsigned sho
                 int N = (interval.right - interval.left);
                 LOG_OP(context, cost, to_string(Opreation::Question), N)
                 int qBlc = (N + thread_count - 1) / thread_count;
-                QuestionMark<<<qBlc, thread_count>>> (interval, context.deviceContext());
-                checkCuda(cudaGetLastError());
-                if (context.syncAndCheck(N)) {
-                    intervals.end(cost, Opreation::Question) = INT_MAX; goto exitEnumeration;
-                }
-
-                if (checkTime(startTime, maxTime)) { goto exitEnumeration; }
+                launches.push_back({ Opreation::Question, N, [=](Context::Device device, cudaStream_t stream) {
+                    QuestionMark<<<qBlc, thread_count, 0, stream>>>(interval, device);
+                }, false });
             }
         }
-        intervals.end(cost, Opreation::Question) = context.lastIdx;
 
         // Star
         if (cost >= costs.alpha + costs.star) {
@@ -1017,41 +1284,45 @@ paresy_s::Result paresy_s::REI(const unsigned short* costFun, const unsigned sho
             {
                 int N = (interval.right - interval.left);
                 LOG_OP(context, cost, to_string(Opreation::Star), N)
-                    int qBlc = (N + thread_count - 1) / thread_count;
-                Star<<<qBlc, thread_count>>>(interval, guideTable.deviceTable(), context.deviceContext());
-                checkCuda(cudaGetLastError());
-                if (context.syncAndCheck(N)) {
-                    intervals.end(cost, Opreation::Star) = INT_MAX; goto exitEnumeration;
-                }
-
-                if (checkTime(startTime, maxTime)) { goto exitEnumeration; }
+                int qBlc = (N + thread_count - 1) / thread_count;
+                auto table = guideTable.deviceTable();
+                launches.push_back({ Opreation::Star, N, [=](Context::Device device, cudaStream_t stream) {
+                    Star<<<qBlc, thread_count, 0, stream>>>(interval, table, device);
+                }, false });
             }
         }
-        intervals.end(cost, Opreation::Star) = context.lastIdx;
 
-        
+        // Character classes and seeds, they are stored with the concatenations
+        auto level = atoms.level(cost);
+        for (auto chunk : paresy_s::splitInterval(level.left, level.right, temp_langCacheCapacity))
+        {
+            int N = chunk.right - chunk.left;
+            int first = chunk.left;
+            LOG_OP(context, cost, std::string("Atoms"), N)
+            const CS* d_atoms = context.d_extraAtoms;
+            launches.push_back({ Opreation::Concatenate, N, [=](Context::Device device, cudaStream_t stream) {
+                Atoms<<<(N + 127) / 128, 128, 0, stream>>>(d_atoms, first, N, device);
+            }, false });
+        }
+
         //Concat
         for (int i = costs.alpha; 2 * i <= cost - costs.concat; ++i) {
 
             auto [lstart, lend] = intervals.Interval(i);
             auto [rstart, rend] = intervals.Interval(cost - i - costs.concat);
 
-            for (auto interval : paresy_s::splitInterval(rstart, rend, temp_langCacheCapacity/(2*(lend - lstart))))
+            // every pair gives two candidates
+            for (auto tile : paresy_s::TileScheduler(Pair<int>(rstart, rend), Pair<int>(lstart, lend), temp_langCacheCapacity / 2))
             {
-                int N = (interval.right - interval.left) * (lend - lstart);
+                int N = tile.size();
                 LOG_OP(context, cost, to_string(Opreation::Concatenate), 2 * N)
-
                 int qBlc = (N + thread_count - 1) / thread_count;
-                Concat<<<qBlc, thread_count >>>(interval, Pair<int>(lstart, lend), guideTable.deviceTable(), context.deviceContext());
-                checkCuda(cudaGetLastError());
-                if (context.syncAndCheck(N * 2)) {
-                    intervals.end(cost, Opreation::Concatenate) = INT_MAX; goto exitEnumeration;
-                }
-
-                if (checkTime(startTime, maxTime)) { goto exitEnumeration; }
+                auto table = guideTable.deviceTable();
+                launches.push_back({ Opreation::Concatenate, 2 * N, [=](Context::Device device, cudaStream_t stream) {
+                    Concat<<<qBlc, thread_count, 0, stream>>>(tile.left, tile.right, table, device);
+                }, false });
             }
         }
-        intervals.end(cost, Opreation::Concatenate) = context.lastIdx;
 
         //Or
         if (!useQuestionOverOr && cost >= 2 * costs.alpha + costs.alternation) {
@@ -1063,13 +1334,9 @@ paresy_s::Result paresy_s::REI(const unsigned short* costFun, const unsigned sho
                 int N = (interval.right - interval.left);
                 LOG_OP(context, cost, to_string(Opreation::Or), N)
                 int qBlc = (N + thread_count - 1) / thread_count;
-                OrEpsilon<<<qBlc, thread_count >>>(interval, context.deviceContext());
-                checkCuda(cudaGetLastError());
-                if (context.syncAndCheck(N)) {
-                    intervals.end(cost, Opreation::Or) = INT_MAX; goto exitEnumeration;
-                }
-
-                if (checkTime(startTime, maxTime)) { goto exitEnumeration; }
+                launches.push_back({ Opreation::Or, N, [=](Context::Device device, cudaStream_t stream) {
+                    OrEpsilon<<<qBlc, thread_count, 0, stream>>>(interval, device);
+                }, false });
             }
         }
         for (int i = costs.alpha; 2 * i <= cost - costs.alternation; ++i) {
@@ -1077,22 +1344,32 @@ paresy_s::Result paresy_s::REI(const unsigned short* costFun, const unsigned sho
             auto [lstart, lend] = intervals.Interval(i);
             auto [rstart, rend] = intervals.Interval(cost - i - costs.alternation);
 
-            for (auto interval : paresy_s::splitInterval(rstart, rend, temp_langCacheCapacity / (lend - lstart)))
+            // Both sides are the same interval, (y, x) and (x, x) only give duplicates
+            if (2 * i == cost - costs.alternation) {
+                Pair<int> interval(lstart, lend);
+                uint64_t pairs = paresy_s::triangularCount(lend - lstart);
+                for (uint64_t first = 0; first < pairs; first += temp_langCacheCapacity)
+                {
+                    int N = static_cast<int>(std::min<uint64_t>(temp_langCacheCapacity, pairs - first));
+                    LOG_OP(context, cost, to_string(Opreation::Or), N)
+                    int qBlc = (N + thread_count - 1) / thread_count;
+                    launches.push_back({ Opreation::Or, N, [=](Context::Device device, cudaStream_t stream) {
+                        OrTriangle<<<qBlc, thread_count, 0, stream>>>(interval, first, N, device);
+                    }, true });
+                }
+                continue;
+            }
+
+            for (auto tile : paresy_s::TileScheduler(Pair<int>(rstart, rend), Pair<int>(lstart, lend), temp_langCacheCapacity))
             {
-                int N = (interval.right - interval.left) * (lend - lstart);
+                int N = tile.size();
                 LOG_OP(context, cost, to_string(Opreation::Or), N)
-
                 int qBlc = (N + thread_count - 1) / thread_count;
-                Or<<<qBlc, thread_count >>>(interval, Pair<int>(lstart, lend), context.deviceContext());
-                checkCuda(cudaGetLastError());
-                if (context.syncAndCheck(N)) {
-                    intervals.end(cost, Opreation::Or) = INT_MAX; goto exitEnumeration;
-                }
-
-                if (checkTime(startTime, maxTime)) { goto exitEnumeration; }
+                launches.push_back({ Opreation::Or, N, [=](Context::Device device, cudaStream_t stream) {
+                    Or<<<qBlc, thread_count, 0, stream>>>(tile.left, tile.right, device);
+                }, true });
             }
         }
-        intervals.end(cost, Opreation::Or) = context.lastIdx;
 
         //And
         for (int i = costs.alpha; 2 * i <= cost - costs.intersection; ++i) {
@@ -1100,36 +1377,58 @@ paresy_s::Result paresy_s::REI(const unsigned short* costFun, const unsigned sho
             auto [lstart, lend] = intervals.Interval(i);
             auto [rstart, rend] = intervals.Interval(cost - i - costs.intersection);
 
-            for (auto interval : paresy_s::splitInterval(rstart, rend, temp_langCacheCapacity / (lend - lstart)))
-            {
-                int N = (interval.right - interval.left) * (lend - lstart);
-                LOG_OP(context, cost, to_string(Opreation::And), N)
-
+            if (2 * i == cost - costs.intersection) {
+                Pair<int> interval(lstart, lend);
+                uint64_t pairs = paresy_s::triangularCount(lend - lstart);
+                for (uint64_t first = 0; first < pairs; first += temp_langCacheCapacity)
+                {
+                    int N = static_cast<int>(std::min<uint64_t>(temp_langCacheCapacity, pairs - first));
+                    LOG_OP(context, cost, to_string(Opreation::And), N)
                     int qBlc = (N + thread_count - 1) / thread_count;
-                And << <qBlc, thread_count >> > (interval, Pair<int>(lstart, lend), context.deviceContext());
-                checkCuda(cudaGetLastError());
-                if (context.syncAndCheck(N)) {
-                    intervals.end(cost, Opreation::And) = INT_MAX; goto exitEnumeration;
+                    launches.push_back({ Opreation::And, N, [=](Context::Device device, cudaStream_t stream) {
+                        AndTriangle<<<qBlc, thread_count, 0, stream>>>(interval, first, N, device);
+                    }, true });
                 }
+                continue;
+            }
 
-                if (checkTime(startTime, maxTime)) { goto exitEnumeration; }
+            for (auto tile : paresy_s::TileScheduler(Pair<int>(rstart, rend), Pair<int>(lstart, lend), temp_langCacheCapacity))
+            {
+                int N = tile.size();
+                LOG_OP(context, cost, to_string(Opreation::And), N)
+                int qBlc = (N + thread_count - 1) / thread_count;
+                launches.push_back({ Opreation::And, N, [=](Context::Device device, cudaStream_t stream) {
+                    And<<<qBlc, thread_count, 0, stream>>>(tile.left, tile.right, device);
+                }, true });
             }
         }
-        intervals.end(cost, Opreation::And) = context.lastIdx;
 
-        if (lastRound) break;
+        // In "OnTheFly" mode the new REs are not stored, so there is nothing left to do for the pairs
+        // that the lookups have covered
+        switch (runLevel(context, intervals, cost, paresy_s::lastReadCost(costs, maxCost), launches, pairsLookedUp, startTime, maxTime))
+        {
+        case LaunchStatus::Found:
+        case LaunchStatus::TimeOut:
+            goto exitEnumeration;
+        default:
+            break;
+        }
+
+        if (lastRound || context.solutions.done(cost)) break;
         if (context.onTheFly && shortageCost == -1) shortageCost = cost;
     }
 
     exitEnumeration:
 
+    if (!context.solutions.empty()) return solutionsResult(context, intervals, cost, guideTable.ICsize);
+
     if (context.isFound)
     {
 #if LOG_LEVEL >= 2
         if(context.onTheFly){ printf("\"OnTheFly\" mode has been used\n"); }
 #endif
         RE = REtoString(context, intervals);
-        return Result(RE, cost, context.allREs, guideTable.ICsize);
+        return paresy_s::Result(RE, cost, context.allREs, guideTable.ICsize);
     }
 
 #if LOG_LEVEL >= 2
@@ -1142,4 +1441,62 @@ paresy_s::Result paresy_s::REI(const unsigned short* costFun, const unsigned sho
 #endif
 
     return paresy_s::Result("not_found", cost > maxCost ? maxCost : cost, context.allREs, guideTable.ICsize);
+}
+
+paresy_s::Result enumerate(const unsigned short* costFun, const unsigned short maxCost, const std::vector<std::string>& pos, const std::vector<std::string>& neg,
+    double maxTime, const paresy_s::AlphabetClasses& classes, const std::vector<paresy_s::Seed>& seeds = {}) {
+    DeviceExamples examples(pos, neg);
+    return enumerate(examples, costFun, maxCost, pos, neg, maxTime, classes, seeds);
+}
+
+paresy_s::Result paresy_s::REI(const unsigned short* costFun, const unsigned short maxCost, const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime,
+    const std::vector<Seed>& seeds) {
+
+#ifdef ALPHABET_CLASSES
+    // Enumerating over the representatives of the classes, they are expanded back in the output
+    AlphabetClasses classes(pos, neg);
+    if (classes.merged() && seeds.empty())
+    {
+#if LOG_LEVEL >= 2
+        printf("The alphabet has been compressed into classes\n");
+#endif
+        return classes.expandCost(enumerate(costFun, maxCost, classes.project(pos), classes.project(neg), maxTime, classes), costFun);
+    }
+#endif
+
+    return enumerate(costFun, maxCost, pos, neg, maxTime, AlphabetClasses(), seeds);
+}
+
+paresy_s::Result paresy_s::REI(const HostExamples& examples, const unsigned short* costFun, const unsigned short maxCost,
+    const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime, const std::vector<Seed>& seeds, bool) {
+
+#ifdef ALPHABET_CLASSES
+    // the infix-closure of the representatives is another one
+    if (seeds.empty() && AlphabetClasses(pos, neg).merged())
+    { return REI(costFun, maxCost, pos, neg, maxTime); }
+#endif
+
+    DeviceExamples deviceExamples(examples);
+    return enumerate(deviceExamples, costFun, maxCost, pos, neg, maxTime, AlphabetClasses(), seeds);
+}
+
+std::vector<paresy_s::Result> paresy_s::REI(const std::vector<const unsigned short*>& costFuns, const unsigned short maxCost,
+    const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime) {
+
+#ifdef ALPHABET_CLASSES
+    AlphabetClasses classes(pos, neg);
+    if (classes.merged())
+    {
+        auto projectedPos = classes.project(pos), projectedNeg = classes.project(neg);
+        DeviceExamples examples(projectedPos, projectedNeg);
+        return enumerateBatch(costFuns, maxCost, [&](const unsigned short* costFun) {
+            return classes.expandCost(enumerate(examples, costFun, maxCost, projectedPos, projectedNeg, maxTime, classes), costFun);
+        });
+    }
+#endif
+
+    DeviceExamples examples(pos, neg);
+    return enumerateBatch(costFuns, maxCost, [&](const unsigned short* costFun) {
+        return enumerate(examples, costFun, maxCost, pos, neg, maxTime, AlphabetClasses());
+    });
 }
\ No newline at end of file
@@ -3,14 +3,51 @@
 #include <set>
 #include <algorithm>
 #include <random>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <climits>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <rei.h>
+#include <rei_host.hpp>
 #include <regex_match.hpp>
+#include <worker_pool.hpp>
 
 using std::vector;
 using std::set;
 using std::string;
 using std::tuple;
 
+#ifndef SPECULATIVE_SAMPLES
+#define SPECULATIVE_SAMPLES 0
+#endif
+#ifndef SPECULATIVE_GRACE
+#define SPECULATIVE_GRACE 0
+#endif
+#ifndef SPECULATIVE_SEED
+#define SPECULATIVE_SEED 0
+#endif
+
+ paresy_s::Result paresy_s::reiSolver(const HostExamples& examples, const unsigned short* costFun, const unsigned short maxCost,
+     const vector<string>& pos, const vector<string>& neg, double maxTime, const vector<Seed>& seeds, bool checkpoint) {
+#ifndef HOST_ONLY
+     // An enumeration takes most of the free memory of the device, the calls of several threads take turns
+     static std::mutex device;
+     std::lock_guard<std::mutex> lock(device);
+     // a sample that has been stopped while it was waiting for its turn
+     if (StopScope::stopped()) return Result("not_found", 0, 0, 0);
+#endif
+     return REI(examples, costFun, maxCost, pos, neg, maxTime, seeds, checkpoint);
+ }
+
+ paresy_s::Result paresy_s::hostSolver(const HostExamples& examples, const unsigned short* costFun, const unsigned short maxCost,
+     const vector<string>& pos, const vector<string>& neg, double maxTime, const vector<Seed>& seeds, bool checkpoint) {
+     return hostEnumerate(examples, costFun, maxCost, pos, neg, maxTime, AlphabetClasses(), seeds, checkpoint);
+ }
+
  tuple<vector<string>, vector<string>> midSplit(const vector<string>& vec) {
     auto midPos = vec.begin() + vec.size() / 2;
     vector<string> p1(vec.begin(), midPos);
@@ -18,15 +55,59 @@ using std::tuple;
     return { p1, p2 };
 }
 
- bool matchesAll(const vector<string>& examples, const string& pattern) {
-    auto matchResult = match(examples, pattern);
-    return all_of(matchResult.begin(), matchResult.end(), [](bool val) { return val; });
-}
+ // Full evaluation, used when the accepted examples themselves are needed
+ vector<bool> filter(const vector<string>& examples, const string& pattern, paresy_s::RecursiveProfileInfo& profileInfo) {
+     profileInfo.matchCalls += examples.size();
+     profileInfo.exhaustiveMatchCalls += examples.size();
+     return match(examples, pattern);
+ }
 
- bool matchesNone(const vector<string>& examples, const string& pattern) {
-    auto matchResult = match(examples, pattern);
-    return none_of(matchResult.begin(), matchResult.end(), [](bool val) { return val; });
-}
+ bool acceptsAll(const vector<bool>& filter) {
+     return all_of(filter.begin(), filter.end(), [](bool val) { return val; });
+ }
+
+ bool rejectsAll(const vector<bool>& filter) {
+     return none_of(filter.begin(), filter.end(), [](bool val) { return val; });
+ }
+
+ // The part of a set of examples with the given membership in filter
+ vector<bool> where(const vector<bool>& filter, bool expected) {
+     vector<bool> res(filter.size());
+     for (size_t i = 0; i < filter.size(); ++i) res[i] = filter[i] == expected;
+     return res;
+ }
+
+ // The part of a set of examples that midSplit has cut at front: the front ones when inFront, and the back
+ // ones whose membership in the filter of the back is the given one
+ vector<bool> where(size_t front, bool inFront, const vector<bool>& backFilter, bool expected) {
+     vector<bool> res(front, inFront);
+     for (bool accepted : backFilter) res.push_back(accepted == expected);
+     return res;
+ }
+
+ paresy_s::ConsistencyChecker::ConsistencyChecker(const vector<string>& examples, RecursiveProfileInfo& profileInfo)
+     : examples(examples), order(examples.size()), profileInfo(profileInfo) {
+     for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+ }
+
+ bool paresy_s::ConsistencyChecker::check(const string& pattern, bool expected, const vector<bool>* within) {
+     vector<int> part;
+     if (within) for (int i : order) if ((*within)[i]) part.push_back(i);
+     const vector<int>& visited = within ? part : order;
+
+     profileInfo.exhaustiveMatchCalls += visited.size();
+
+     // a leaf that runs along with others checks on its part of the cores
+     int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+     int threads = std::max(1, cores / ResourceShare::parts());
+     long violation = firstViolation(examples, visited, pattern, expected, profileInfo.matchCalls, threads);
+     if (violation == -1) return true;
+
+     // move to front, in the order of the whole set
+     auto it = std::find(order.begin(), order.end(), visited[violation]);
+     std::rotate(order.begin(), it, it + 1);
+     return false;
+ }
 
  vector<string> select(const vector<string>& vec, const vector<bool>& filter) {
     vector<string> res;
@@ -76,8 +157,50 @@ string alternation(const string& r1, const string& r2) {
     return "(" + r1 + ")+(" + r2 + ")";
 }
 
- string paresy_s::detSplit(int window, const unsigned short* costFun, const unsigned short maxCost,
-    const vector<string>& pos, const vector<string>& neg, double maxTime, paresy_s::RecursiveProfileInfo& profileInfo) {
+#ifdef FRAGMENT_SEEDS
+ // The combinations of the fragments are only looked for up to this many of the most expensive operation, they are
+ // cheap to find at that cost. A larger one is not worth an enumeration that can run out of memory instead
+ const int fragmentCombinationCost = 8;
+
+ // Running paresy on a window of the examples with the fragments that the sub-calls have found as seeds, each one as
+ // cheap as a character. The positives that the fragments don't accept yet come first in the window.
+ // Returns the RE when it is consistent with all the examples, so the sub-calls for the rest are not needed
+ string combineFragments(const paresy_s::ICProjection& ic, int window, const unsigned short* costFun, const unsigned short maxCost, const vector<string>& uncovered,
+     const vector<string>& pos, const vector<string>& neg, paresy_s::ConsistencyChecker& posCheck, paresy_s::ConsistencyChecker& negCheck,
+     const vector<string>& fragments, double maxTime, paresy_s::RecursiveProfileInfo& profileInfo, const paresy_s::LeafSolver& solver) {
+
+     vector<paresy_s::Seed> seeds;
+     for (const auto& fragment : fragments)
+         if (fragment != "eps" && none_of(seeds.begin(), seeds.end(), [&](const paresy_s::Seed& seed) { return seed.RE == fragment; }))
+             seeds.push_back({ fragment, costFun[0] });
+
+     int combinationCost = std::min<int>(maxCost, fragmentCombinationCost * *std::max_element(costFun, costFun + 6));
+
+     size_t posCount = std::min(pos.size(), static_cast<size_t>(window / 2));
+     vector<string> samplePos(uncovered.begin(), uncovered.begin() + std::min(uncovered.size(), posCount));
+     set<string> sampled(samplePos.begin(), samplePos.end());
+     for (size_t i = 0; i < pos.size() && samplePos.size() < posCount; ++i)
+         if (sampled.insert(pos[i]).second) samplePos.push_back(pos[i]);
+
+     vector<string> sampleNeg(neg.begin(), neg.begin() + std::min(neg.size(), window - samplePos.size()));
+
+     // it is a call of the solver like the leaves, so it is counted as one
+     profileInfo.enter();
+     string output = solver(ic.project(samplePos, sampleNeg), costFun, combinationCost, samplePos, sampleNeg, maxTime, seeds, false).RE;
+     profileInfo.exit();
+ #if LOG_LEVEL >= 1
+     printf("paresy output with the fragments: %s\n", output.c_str());
+ #endif
+     if (output == "not_found" || output == "eps" || output == "Empty") return "";
+
+     if (posCheck.acceptsAll(output) && negCheck.rejectsAll(output))
+         return output;
+     return "";
+ }
+#endif
+
+ string detSplit(const paresy_s::ICProjection& ic, int window, const unsigned short* costFun, const unsigned short maxCost,
+    const vector<string>& pos, const vector<string>& neg, double maxTime, paresy_s::RecursiveProfileInfo& profileInfo, const paresy_s::LeafSolver& solver) {
 
     profileInfo.enter();
 
@@ -86,7 +209,7 @@ string alternation(const string& r1, const string& r2) {
 #endif
 
     if (pos.size() + neg.size() <= static_cast<size_t>(window)) {
-        string output = paresy_s::REI(costFun, maxCost, pos, neg, maxTime).RE;
+        string output = solver(ic.project(pos, neg), costFun, maxCost, pos, neg, maxTime, {}, ic.isRoot(pos, neg)).RE;
 #if LOG_LEVEL >= 1
         printf("paresy output: %s\n", output.c_str());
 #endif
@@ -96,16 +219,19 @@ string alternation(const string& r1, const string& r2) {
     auto [p1, p2] = midSplit(pos);
     auto [n1, n2] = midSplit(neg);
 
-    string r11 = detSplit(window, costFun, maxCost, p1, n1, maxTime, profileInfo);
-    profileInfo.exit();
+    // The checks of this call on the parts of its positives and of its negatives
+    paresy_s::ConsistencyChecker posCheck(pos, profileInfo), negCheck(neg, profileInfo);
 
-    auto r11FilterOnP2 = match(p2, r11);
-    auto r11FilterOnN2 = match(n2, r11);
+    string r11 = detSplit(ic, window, costFun, maxCost, p1, n1, maxTime, profileInfo, solver);
+    profileInfo.exit();
 
-    bool r11AcceptsTheWholeP2 = all_of(r11FilterOnP2.begin(), r11FilterOnP2.end(), [](bool val) { return val; });
-    bool r11RejectsTheWholeN2 = none_of(r11FilterOnN2.begin(), r11FilterOnN2.end(), [](bool val) { return val; });
+    // The filter on n2 is needed when r11 doesn't reject all of it, so it's fully evaluated
+    auto r11FilterOnN2 = filter(n2, r11, profileInfo);
+    bool r11RejectsTheWholeN2 = rejectsAll(r11FilterOnN2);
 
-    if (r11AcceptsTheWholeP2 && r11RejectsTheWholeN2) return r11;
+    vector<bool> inP2(p1.size(), false);
+    inP2.resize(pos.size(), true);
+    if (r11RejectsTheWholeN2 && posCheck.acceptsAll(r11, inP2)) return r11;
 
     string left;
     if (r11RejectsTheWholeN2) {
@@ -113,34 +239,36 @@ string alternation(const string& r1, const string& r2) {
     }
     else {
         vector<string> n2Andr11 = select(n2, r11FilterOnN2);
-        string r12 = detSplit(window, costFun, maxCost, p1, n2Andr11, maxTime, profileInfo);
+        string r12 = detSplit(ic, window, costFun, maxCost, p1, n2Andr11, maxTime, profileInfo, solver);
         profileInfo.exit();
 
-        vector<string> negMinusN2Andr11 = subtract(neg, n2Andr11);
-
-        if (matchesNone(negMinusN2Andr11, r12))
+        // the negatives but the ones of n2 that r11 accepts
+        if (negCheck.rejectsAll(r12, where(n1.size(), true, r11FilterOnN2, false)))
             left = r12;
         else
             left = intersect(r11, r12);
-
-        if (matchesAll(p2, left)) return left;
     }
 
-    auto leftFilterOnP2 = match(p2, left);
+    auto leftFilterOnP2 = filter(p2, left, profileInfo);
+    if (acceptsAll(leftFilterOnP2)) return left;
+
     vector<string> p2MinusLeft = selectInverse(p2, leftFilterOnP2);
 
-    string r21 = detSplit(window, costFun, maxCost, p2MinusLeft, n1, maxTime, profileInfo);
-    profileInfo.exit();
+#ifdef FRAGMENT_SEEDS
+    string combined = combineFragments(ic, window, costFun, maxCost, p2MinusLeft, pos, neg, posCheck, negCheck, { r11, left }, maxTime, profileInfo, solver);
+    if (!combined.empty()) return combined;
+#endif
 
-    vector<string> p1MinusP2MinusLeft = subtract(pos, p2MinusLeft);
+    string r21 = detSplit(ic, window, costFun, maxCost, p2MinusLeft, n1, maxTime, profileInfo, solver);
+    profileInfo.exit();
 
-    auto r21FilterOnP1 = match(p1MinusP2MinusLeft, r21);
-    auto r21FilterOnN2 = match(n2, r21);
+    // the positives but the ones of p2 that left rejects
+    vector<bool> posMinusP2MinusLeft = where(p1.size(), true, leftFilterOnP2, true);
 
-    bool r21AcceptsTheWholeP1 = all_of(r21FilterOnP1.begin(), r21FilterOnP1.end(), [](bool val) { return val; });
-    bool r21RejectsTheWholeN2 = none_of(r21FilterOnN2.begin(), r21FilterOnN2.end(), [](bool val) { return val; });
+    auto r21FilterOnN2 = filter(n2, r21, profileInfo);
+    bool r21RejectsTheWholeN2 = rejectsAll(r21FilterOnN2);
 
-    if (r21AcceptsTheWholeP1 && r21RejectsTheWholeN2) return r21;
+    if (r21RejectsTheWholeN2 && posCheck.acceptsAll(r21, posMinusP2MinusLeft)) return r21;
 
     string right;
     if (r21RejectsTheWholeN2) {
@@ -148,89 +276,285 @@ string alternation(const string& r1, const string& r2) {
     }
     else {
         vector<string> n2Andr21 = select(n2, r21FilterOnN2);
-        string r22 = detSplit(window, costFun, maxCost, p2MinusLeft, n2Andr21, maxTime, profileInfo);
+        string r22 = detSplit(ic, window, costFun, maxCost, p2MinusLeft, n2Andr21, maxTime, profileInfo, solver);
         profileInfo.exit();
 
-        vector<string> negMinusN2Andr21 = subtract(neg, n2Andr21);
-
-        if (matchesNone(negMinusN2Andr21, r22)) {
+        // the negatives but the ones of n2 that r21 accepts
+        if (negCheck.rejectsAll(r22, where(n1.size(), true, r21FilterOnN2, false))) {
             right = r22;
         }
         else {
             right = intersect(r21, r22);
         }
 
-        vector<string> posMinusP2MinusLeft = subtract(pos, p2MinusLeft);
-        if (matchesAll(posMinusP2MinusLeft, right)) return right;
+        if (posCheck.acceptsAll(right, posMinusP2MinusLeft)) return right;
     }
 
     return alternation(left, right);
 }
 
- vector<string> randomSample(const vector<string>& input, size_t sampleSize, unsigned int seed = 0) {
+ vector<string> randomSample(const vector<string>& input, size_t sampleSize, std::mt19937& rng) {
      vector<string> result;
 
      if (sampleSize >= input.size()) {
          return input;
      }
 
-     static std::mt19937 rng(seed);
      result.reserve(sampleSize);
      sample(input.begin(), input.end(), back_inserter(result), sampleSize, rng);
      return result;
  }
 
- string paresy_s::randSplit(int window, const unsigned short* costFun, const unsigned short maxCost,
-     const vector<string>& pos, const vector<string>& neg, double maxTime, paresy_s::RecursiveProfileInfo& profileInfo) {
+ // The random stream that the samples of randSplit share, from the first call of the process on
+ std::mt19937& sharedRng() {
+     static std::mt19937 rng(0);
+     return rng;
+ }
 
-    profileInfo.enter();
+ // The infix-closure sizes and the times of the leaf calls of a randSplit run. The sample of the next call is kept
+ // within the CS bits, and within the size that the earlier calls expect to take half of the time limit, from a fit
+ // of the log of the time to the size. A call that has run out of time counts with the time limit
+ class WindowModel {
+ public:
+     explicit WindowModel(double maxTime) : maxTime(maxTime) {}
 
-#if LOG_LEVEL >= 1
-    printf("=== split at depth: %u, call count: %u, pos: %u, neg: %u ===\n", profileInfo.maxDepth, profileInfo.callCount, (int)pos.size(), (int)neg.size());
+     void record(int size, double seconds) {
+         double y = std::log(std::max(std::min(seconds, maxTime), 1e-6));
+         ++n; sx += size; sy += y; sxx += (double)size * size; sxy += size * y;
+     }
+
+     int budget() const {
+         int limit = static_cast<int>(sizeof(CS) * 8);
+
+         double variance = n * sxx - sx * sx;
+         if (n >= 2 && variance > 0) {
+             double slope = (n * sxy - sx * sy) / variance;
+             double intercept = (sy - slope * sx) / n;
+             if (slope > 0) {
+                 double expected = (std::log(maxTime / 2) - intercept) / slope;
+                 limit = static_cast<int>(std::min<double>(limit, std::max(expected, 1.0)));
+             }
+         }
+         return limit;
+     }
+
+ private:
+     double maxTime;
+     int n = 0;
+     double sx = 0, sy = 0, sxx = 0, sxy = 0;
+ };
+
+ // Taking the words in a random order, a positive and a negative in turn, as long as the infix-closure stays
+ // within the budget. A word that doesn't fit is left out, and a shorter one may come after it
+ tuple<vector<string>, vector<string>, int> adaptiveSample(const paresy_s::ICProjection& ic, int budget, size_t window,
+     const vector<string>& pos, const vector<string>& neg, std::mt19937& rng) {
+
+     vector<string> posOrder(pos), negOrder(neg);
+     shuffle(posOrder.begin(), posOrder.end(), rng);
+     shuffle(negOrder.begin(), negOrder.end(), rng);
+
+     paresy_s::SampleClosure closure(ic, budget);
+     vector<string> p1, n1;
+     size_t i = 0, j = 0;
+     while (p1.size() + n1.size() < window && (i < posOrder.size() || j < negOrder.size())) {
+         if (j >= negOrder.size() || (i < posOrder.size() && p1.size() <= n1.size())) {
+             if (closure.add(posOrder[i])) p1.push_back(posOrder[i]);
+             ++i;
+         }
+         else {
+             if (closure.add(negOrder[j])) n1.push_back(negOrder[j]);
+             ++j;
+         }
+     }
+
+     return { p1, n1, closure.size() };
+ }
+
+ // What the calls of a randSplit run share
+ struct RandSplitRun {
+     RandSplitRun(const vector<string>& pos, const vector<string>& neg, double maxTime) : ic(pos, neg), model(maxTime) {
+         if (SPECULATIVE_SAMPLES > 0) pool = std::make_unique<paresy_s::WorkerPool>(SPECULATIVE_SAMPLES);
+     }
+
+     paresy_s::ICProjection ic;
+     WindowModel model;
+     std::unique_ptr<paresy_s::WorkerPool> pool;
+ };
+
+ struct LeafSample {
+     vector<string> pos, neg;
+     // the size of its infix-closure, with ADAPTIVE_WINDOW
+     int closureSize = 0;
+ };
+
+ // Up to win of the examples, half of them positive when there are enough of both
+ LeafSample countSample(int win, const vector<string>& pos, const vector<string>& neg, std::mt19937& rng) {
+     LeafSample sample;
+     if (pos.size() + neg.size() <= static_cast<size_t>(win)) {
+         sample.pos = pos;
+         sample.neg = neg;
+     }
+     else {
+         if (pos.size() <= static_cast<size_t>(win / 2)) {
+             sample.pos = pos;
+             sample.neg = randomSample(neg, win - sample.pos.size(), rng);
+         }
+         else if (neg.size() <= static_cast<size_t>(win / 2)) {
+             sample.neg = neg;
+             sample.pos = randomSample(pos, win - sample.neg.size(), rng);
+         }
+         else {
+             sample.pos = randomSample(pos, win / 2, rng);
+             sample.neg = randomSample(neg, win - sample.pos.size(), rng);
+         }
+     }
+     return sample;
+ }
+
+ // The size of the infix-closure of the words
+ int closureSize(const paresy_s::ICProjection& ic, const vector<string>& words) {
+     paresy_s::SampleClosure closure(ic, INT_MAX);
+     for (const auto& word : words) closure.add(word);
+     return closure.size();
+ }
+
+ // The infix-closure of the shortest positive and the shortest negative. A smaller budget can't take a positive
+ // and a negative at all, so the model doesn't go below it after a run of slow calls
+ int minimalBudget(const paresy_s::ICProjection& ic, const vector<string>& pos, const vector<string>& neg) {
+     auto shorter = [](const string& a, const string& b) { return a.size() < b.size(); };
+     vector<string> words;
+     if (!pos.empty()) words.push_back(*std::min_element(pos.begin(), pos.end(), shorter));
+     if (!neg.empty()) words.push_back(*std::min_element(neg.begin(), neg.end(), shorter));
+     return closureSize(ic, words);
+ }
+
+ // A sample by the infix-closure with ADAPTIVE_WINDOW, or by the count of the words
+ LeafSample drawSample([[maybe_unused]] const RandSplitRun& run, int win, const vector<string>& pos, const vector<string>& neg, std::mt19937& rng) {
+#ifdef ADAPTIVE_WINDOW
+     LeafSample sample;
+     int budget = std::max(run.model.budget(), minimalBudget(run.ic, pos, neg));
+     std::tie(sample.pos, sample.neg, sample.closureSize) = adaptiveSample(run.ic, budget, win, pos, neg, rng);
+     if (!sample.pos.empty() || pos.empty()) return sample;
+
+     // The positives that the random order has reached didn't fit, a call without any would only find empty
+     sample = countSample(win, pos, neg, rng);
+     vector<string> words(sample.pos);
+     words.insert(words.end(), sample.neg.begin(), sample.neg.end());
+     sample.closureSize = closureSize(run.ic, words);
+     return sample;
+#else
+     return countSample(win, pos, neg, rng);
 #endif
+ }
 
-    int seed = 0;
-    int win = window;
+ paresy_s::Result solveSample(const RandSplitRun& run, const LeafSample& sample, const unsigned short* costFun, const unsigned short maxCost,
+     double maxTime, const paresy_s::LeafSolver& solver, double& seconds) {
+
+ #if LOG_LEVEL >= 1
+     printf("running paresy with pos %u, neg %u\n", (int)sample.pos.size(), (int)sample.neg.size());
+ #endif
+     auto startTime = std::chrono::steady_clock::now();
+     auto result = solver(run.ic.project(sample.pos, sample.neg), costFun, maxCost, sample.pos, sample.neg, maxTime, {}, run.ic.isRoot(sample.pos, sample.neg));
+     seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+ #if LOG_LEVEL >= 1
+     printf("paresy output: %s\n", result.RE.c_str());
+ #endif
+     return result;
+ }
 
-    string r11;
+ void recordSample([[maybe_unused]] RandSplitRun& run, [[maybe_unused]] const LeafSample& sample, [[maybe_unused]] double seconds) {
+#ifdef ADAPTIVE_WINDOW
+     run.model.record(sample.closureSize, seconds);
+ #if LOG_LEVEL >= 1
+     printf("infix-closure of the sample: %d bits, next budget: %d\n", sample.closureSize, run.model.budget());
+ #endif
+#endif
+ }
 
-    while (true) {
-        vector<string> p1, n1;
-        if (pos.size() + neg.size() <= static_cast<size_t>(win)) {
-            p1 = pos;
-            n1 = neg;
-        }
-        else {
-            if (pos.size() <= win / 2) {
-                p1 = pos;
-                n1 = randomSample(neg, win - p1.size(), seed);
-            }
-            else if (neg.size() <= win / 2) {
-                n1 = neg;
-                p1 = randomSample(pos, win - n1.size(), seed);
-            }
-            else {
-                p1 = randomSample(pos, win / 2, seed);
-                n1 = randomSample(neg, win - p1.size(), seed);
-            }
-        }
+ // One sample at a time, the window is halved after every one that fails
+ string sequentialLeaf(RandSplitRun& run, int window, const unsigned short* costFun, const unsigned short maxCost,
+     const vector<string>& pos, const vector<string>& neg, double maxTime, const paresy_s::LeafSolver& solver) {
 
-    #if LOG_LEVEL >= 1
-        printf("running paresy with pos %u, neg %u\n",p1.size(), n1.size());
-    #endif
-        string output = paresy_s::REI(costFun, maxCost, p1, n1, maxTime).RE;
-    #if LOG_LEVEL >= 1
-        printf("paresy output: %s\n", output.c_str());
-    #endif
+     for (int win = window; ; win /= 2) {
+         LeafSample sample = drawSample(run, win, pos, neg, sharedRng());
+         double seconds;
+         string output = solveSample(run, sample, costFun, maxCost, maxTime, solver, seconds).RE;
+         recordSample(run, sample, seconds);
 
-        if (output != "not_found")
-        { r11 = output; break; }
-        else
-        { win /= 2; }
-    }
+         if (output != "not_found") return output;
+     }
+ }
+
+ // SPECULATIVE_SAMPLES samples of a round at once, the first half of them of the window and the rest of half of it.
+ // Each one has its own random stream, seeded by SPECULATIVE_SEED, the call and its place in the round. The first one
+ // that is found wins, or the cheapest of the SPECULATIVE_GRACE ones after it, so the choice doesn't depend on the order
+ // they finish in. The samples after those are not started, and the ones of them that are running are stopped.
+ // When none is found the next round halves the smaller window
+ string speculativeLeaf(RandSplitRun& run, int window, const unsigned short* costFun, const unsigned short maxCost,
+     const vector<string>& pos, const vector<string>& neg, double maxTime, paresy_s::RecursiveProfileInfo& profileInfo,
+     const paresy_s::LeafSolver& solver) {
+
+     const int count = SPECULATIVE_SAMPLES;
+
+     for (int round = 0, win = window; ; ++round, win /= (count > 1 ? 4 : 2)) {
+         vector<LeafSample> samples;
+         for (int k = 0; k < count; ++k) {
+             std::seed_seq seq{ static_cast<unsigned>(SPECULATIVE_SEED), static_cast<unsigned>(profileInfo.callCount),
+                 static_cast<unsigned>(round), static_cast<unsigned>(k) };
+             std::mt19937 rng(seq);
+             samples.push_back(drawSample(run, k < (count + 1) / 2 ? win : win / 2, pos, neg, rng));
+         }
+
+         vector<paresy_s::Result> results(count, paresy_s::Result("not_found", 0, 0, 0));
+         vector<double> seconds(count, 0);
+         std::atomic<int> firstFound{ count };
+         vector<std::atomic<bool>> stops(count);
+
+         // the samples run on the threads of the pool, they take their parts of the share of this one
+         int inherited = paresy_s::ResourceShare::parts();
+         run.pool->run(count, [&](int k) {
+             if (k > firstFound.load() + SPECULATIVE_GRACE) return;
+             paresy_s::ResourceShare share(inherited, std::min(count, run.pool->size()));
+             paresy_s::StopScope stop(stops[k]);
+
+             results[k] = solveSample(run, samples[k], costFun, maxCost, maxTime, solver, seconds[k]);
+             if (results[k].RE == "not_found") return;
+
+             int first = firstFound.load();
+             while (k < first && !firstFound.compare_exchange_weak(first, k)) {}
+
+             // the ones after the grace can't be chosen anymore, whatever the others give
+             for (int j = std::min(k, first) + SPECULATIVE_GRACE + 1; j < count; ++j) stops[j] = true;
+         });
+
+         // The samples up to the end of the grace have all run, whatever the order
+         int last = std::min(count - 1, firstFound.load() + SPECULATIVE_GRACE);
+         for (int k = 0; k <= last; ++k) recordSample(run, samples[k], seconds[k]);
+
+         if (firstFound.load() == count) continue;
+
+         int best = firstFound.load();
+         for (int k = best + 1; k <= last; ++k)
+             if (results[k].RE != "not_found" && results[k].REcost < results[best].REcost) best = k;
+         return results[best].RE;
+     }
+ }
+
+ string randSplit(RandSplitRun& run, int window, const unsigned short* costFun, const unsigned short maxCost,
+     const vector<string>& pos, const vector<string>& neg, double maxTime, paresy_s::RecursiveProfileInfo& profileInfo, const paresy_s::LeafSolver& solver) {
+
+    profileInfo.enter();
+
+#if LOG_LEVEL >= 1
+    printf("=== split at depth: %u, call count: %u, pos: %u, neg: %u ===\n", profileInfo.maxDepth, profileInfo.callCount, (int)pos.size(), (int)neg.size());
+#endif
+
+    string r11 = run.pool
+        ? speculativeLeaf(run, window, costFun, maxCost, pos, neg, maxTime, profileInfo, solver)
+        : sequentialLeaf(run, window, costFun, maxCost, pos, neg, maxTime, solver);
 
-    auto r11FilterOnP = match(pos, r11);
-    auto r11FilterOnN = match(neg, r11);
+    auto r11FilterOnP = filter(pos, r11, profileInfo);
+    auto r11FilterOnN = filter(neg, r11, profileInfo);
 
     auto p2 = selectInverse(pos, r11FilterOnP);
     auto n2 = select(neg, r11FilterOnN);
@@ -241,30 +565,39 @@ string alternation(const string& r1, const string& r2) {
     if (p2.size() == 0 && n2.size() == 0)
         return r11;
 
+    // The checks of this call on the parts of its positives and of its negatives
+    paresy_s::ConsistencyChecker posCheck(pos, profileInfo), negCheck(neg, profileInfo);
+    auto inP1 = where(r11FilterOnP, true), inP2 = where(r11FilterOnP, false);
+    auto inN1 = where(r11FilterOnN, false), inN2 = where(r11FilterOnN, true);
+
     string left;
     if (n2.size() == 0)
         left = r11;
     else
     {
-        auto r12 = randSplit(window, costFun, maxCost, p1, n2, maxTime, profileInfo);
+        auto r12 = randSplit(run, window, costFun, maxCost, p1, n2, maxTime, profileInfo, solver);
         profileInfo.exit();
 
-        if (matchesNone(n1, r12))
+        if (negCheck.rejectsAll(r12, inN1))
             left = r12;
         else
             left = intersect(r11, r12);
 
-        if (matchesAll(p2, left))
+        if (posCheck.acceptsAll(left, inP2))
             return left;
     }
 
-    auto r21 = randSplit(window, costFun, maxCost, p2, n1, maxTime, profileInfo);
+#ifdef FRAGMENT_SEEDS
+    string combined = combineFragments(run.ic, window, costFun, maxCost, p2, pos, neg, posCheck, negCheck, { r11, left }, maxTime, profileInfo, solver);
+    if (!combined.empty()) return combined;
+#endif
+
+    auto r21 = randSplit(run, window, costFun, maxCost, p2, n1, maxTime, profileInfo, solver);
     profileInfo.exit();
 
-    bool r21AcceptsTheWholeP1 = matchesAll(p1, r21);
-    bool r21RejectsTheWholeN2 = matchesNone(n2, r21);
+    bool r21RejectsTheWholeN2 = negCheck.rejectsAll(r21, inN2);
 
-    if (r21AcceptsTheWholeP1 && r21RejectsTheWholeN2)
+    if (r21RejectsTheWholeN2 && posCheck.acceptsAll(r21, inP1))
         return r21;
 
     string right;
@@ -272,17 +605,308 @@ string alternation(const string& r1, const string& r2) {
         right = r21;
     else
     {
-        auto r22 = randSplit(window, costFun, maxCost, p2, n2, maxTime, profileInfo);
+        auto r22 = randSplit(run, window, costFun, maxCost, p2, n2, maxTime, profileInfo, solver);
         profileInfo.exit();
 
-        if (matchesNone(n1, r22))
+        if (negCheck.rejectsAll(r22, inN1))
             right = r22;
         else
             right = intersect(r21, r22);
 
-        if (matchesAll(p1, right))
+        if (posCheck.acceptsAll(right, inP1))
             return right;
     }
 
     return alternation(left, right);
+ }
+
+ string paresy_s::detSplit(int window, const unsigned short* costFun, const unsigned short maxCost,
+     const vector<string>& pos, const vector<string>& neg, double maxTime, paresy_s::RecursiveProfileInfo& profileInfo, const LeafSolver& solver) {
+     ICProjection ic(pos, neg);
+     return ::detSplit(ic, window, costFun, maxCost, pos, neg, maxTime, profileInfo, solver);
+ }
+
+ string paresy_s::randSplit(int window, const unsigned short* costFun, const unsigned short maxCost,
+     const vector<string>& pos, const vector<string>& neg, double maxTime, paresy_s::RecursiveProfileInfo& profileInfo, const LeafSolver& solver) {
+     RandSplitRun run(pos, neg, maxTime);
+     return ::randSplit(run, window, costFun, maxCost, pos, neg, maxTime, profileInfo, solver);
+ }
+
+ // The RE of pos and neg that also accepts restPos and rejects restNeg. Those are only checked, and the ones that
+ // it gets wrong are added to the examples of the next solve, so a patch is solved on the new examples and the
+ // counterexamples among the old ones instead of all of them
+ string solveWithRest(int window, const unsigned short* costFun, const unsigned short maxCost, vector<string> pos, vector<string> neg,
+     const vector<string>& restPos, const vector<string>& restNeg, double maxTime, paresy_s::RecursiveProfileInfo& profileInfo,
+     const paresy_s::LeafSolver& solver) {
+
+     paresy_s::ConsistencyChecker restPosCheck(restPos, profileInfo), restNegCheck(restNeg, profileInfo);
+     while (true) {
+         string RE = paresy_s::randSplit(window, costFun, maxCost, pos, neg, maxTime, profileInfo, solver);
+         profileInfo.exit();
+         if (restPosCheck.acceptsAll(RE) && restNegCheck.rejectsAll(RE)) return RE;
+
+         auto wrongPos = selectInverse(restPos, filter(restPos, RE, profileInfo));
+         auto wrongNeg = select(restNeg, filter(restNeg, RE, profileInfo));
+         // nothing to add when the RE doesn't fit pos and neg either
+         if (wrongPos.empty() && wrongNeg.empty()) return RE;
+ #if LOG_LEVEL >= 1
+         printf("=== patch again with counterexamples, pos: %u, neg: %u ===\n", (int)wrongPos.size(), (int)wrongNeg.size());
+ #endif
+         pos.insert(pos.end(), wrongPos.begin(), wrongPos.end());
+         neg.insert(neg.end(), wrongNeg.begin(), wrongNeg.end());
+     }
+ }
+
+ string paresy_s::repairRE(const string& previous, int window, const unsigned short* costFun, const unsigned short maxCost,
+     const vector<string>& pos, const vector<string>& neg, const vector<string>& newPos, const vector<string>& newNeg,
+     double maxTime, paresy_s::RecursiveProfileInfo& profileInfo, const LeafSolver& solver) {
+
+     profileInfo.enter();
+
+     // The earlier examples are consistent with it already
+     shared_ptr<Regex> tree;
+     if (previous != "eps") tree = Parser(previous).parse();
+     auto accepts = [&](const string& word) { return tree ? tree->match(word) : word.empty(); };
+
+     vector<string> wrongPos, wrongNeg;
+     for (const auto& p : newPos) if (!accepts(p)) wrongPos.push_back(p);
+     for (const auto& n : newNeg) if (accepts(n)) wrongNeg.push_back(n);
+     profileInfo.matchCalls += newPos.size() + newNeg.size();
+     profileInfo.exhaustiveMatchCalls += newPos.size() + newNeg.size();
+
+ #if LOG_LEVEL >= 1
+     printf("=== repair, new pos: %u, new neg: %u, wrong pos: %u, wrong neg: %u ===\n",
+         (int)newPos.size(), (int)newNeg.size(), (int)wrongPos.size(), (int)wrongNeg.size());
+ #endif
+
+     if (wrongPos.empty() && wrongNeg.empty()) return previous;
+
+     vector<string> allPos(pos), allNeg(neg);
+     allPos.insert(allPos.end(), newPos.begin(), newPos.end());
+     allNeg.insert(allNeg.end(), newNeg.begin(), newNeg.end());
+     ConsistencyChecker allPosCheck(allPos, profileInfo), allNegCheck(allNeg, profileInfo);
+
+     // The patch that rejects the negatives it accepts and keeps the positives, the new ones decide it
+     string left = previous;
+     if (!wrongNeg.empty()) {
+         string patch = solveWithRest(window, costFun, maxCost, subtract(newPos, wrongPos), wrongNeg, pos, {}, maxTime, profileInfo, solver);
+
+         set<string> wrong(wrongNeg.begin(), wrongNeg.end());
+         vector<bool> others(allNeg.size());
+         for (size_t i = 0; i < allNeg.size(); ++i) others[i] = !wrong.count(allNeg[i]);
+         if (allNegCheck.rejectsAll(patch, others))
+             left = patch;
+         else
+             left = intersect(previous, patch);
+     }
+
+     if (wrongPos.empty()) return left;
+
+     // and the one that accepts the positives it rejects, it has to reject all the negatives
+     string right = solveWithRest(window, costFun, maxCost, wrongPos, newNeg, {}, neg, maxTime, profileInfo, solver);
+
+     set<string> wrong(wrongPos.begin(), wrongPos.end());
+     vector<bool> accepted(allPos.size());
+     for (size_t i = 0; i < allPos.size(); ++i) accepted[i] = !wrong.count(allPos[i]);
+     if (allPosCheck.acceptsAll(right, accepted))
+         return right;
+
+     return alternation(left, right);
+ }
+
+ // The examples of the pool that an RE of the merge tree accepts. The ones of an intersection or an alternation
+ // follow from the ones of its operands, so only the REs that the solver gives are matched, and the intersections with eps
+ struct Membership {
+     vector<bool> pos, neg;
+ };
+
+ Membership matchPool(const string& RE, const vector<string>& pos, const vector<string>& neg, paresy_s::RecursiveProfileInfo& profileInfo) {
+     return { filter(pos, RE, profileInfo), filter(neg, RE, profileInfo) };
+ }
+
+ Membership both(const Membership& a, const Membership& b) {
+     Membership m(a);
+     for (size_t i = 0; i < m.pos.size(); ++i) m.pos[i] = a.pos[i] && b.pos[i];
+     for (size_t i = 0; i < m.neg.size(); ++i) m.neg[i] = a.neg[i] && b.neg[i];
+     return m;
+ }
+
+ Membership either(const Membership& a, const Membership& b) {
+     Membership m(a);
+     for (size_t i = 0; i < m.pos.size(); ++i) m.pos[i] = a.pos[i] || b.pos[i];
+     for (size_t i = 0; i < m.neg.size(); ++i) m.neg[i] = a.neg[i] || b.neg[i];
+     return m;
+ }
+
+ // The indices of the ones of the examples whose membership is the given one
+ vector<int> withMembership(const vector<int>& examples, const vector<bool>& accepted, bool expected) {
+     vector<int> res;
+     for (int i : examples) if (accepted[i] == expected) res.push_back(i);
+     return res;
+ }
+
+ vector<string> wordsOf(const vector<string>& pool, const vector<int>& examples) {
+     vector<string> res;
+     for (int i : examples) res.push_back(pool[i]);
+     return res;
+ }
+
+ vector<int> indexUnion(const vector<int>& a, const vector<int>& b) {
+     vector<int> res;
+     std::set_union(a.begin(), a.end(), b.begin(), b.end(), back_inserter(res));
+     return res;
+ }
+
+ vector<int> indexDifference(const vector<int>& a, const vector<int>& b) {
+     vector<int> res;
+     std::set_difference(a.begin(), a.end(), b.begin(), b.end(), back_inserter(res));
+     return res;
+ }
+
+ // An RE of the merge tree, consistent with the examples of the leaves under it
+ struct MergeNode {
+     string RE;
+     Membership accepted;
+     // the indices in the pool, sorted
+     vector<int> pos, neg;
+ };
+
+ // What the merges of a mergeSplit run share
+ struct MergeRun {
+     const paresy_s::ICProjection& ic;
+     int window;
+     const unsigned short* costFun;
+     unsigned short maxCost;
+     const vector<string>& pos;
+     const vector<string>& neg;
+     double maxTime;
+     const paresy_s::LeafSolver& solver;
+
+     // The RE of a part of the pool, from detSplit, which calls the solver once when it fits in the window
+     MergeNode solve(const vector<int>& p, const vector<int>& n, paresy_s::RecursiveProfileInfo& profileInfo) const {
+         string RE = ::detSplit(ic, window, costFun, maxCost, wordsOf(pos, p), wordsOf(neg, n), maxTime, profileInfo, solver);
+         profileInfo.exit();
+         return { RE, matchPool(RE, pos, neg, profileInfo), p, n };
+     }
+ };
+
+ // Merging two nodes like detSplit puts r11 and r21 together. Each RE is kept when it rejects the negatives of the
+ // other, otherwise it is patched by the RE of its positives and the negatives that it accepts. The left one goes
+ // first, and the right one only has to accept the positives that the left one rejects
+ MergeNode merge(const MergeRun& run, const MergeNode& l, const MergeNode& r, paresy_s::RecursiveProfileInfo& profileInfo) {
+
+     vector<int> allPos = indexUnion(l.pos, r.pos), allNeg = indexUnion(l.neg, r.neg);
+     auto node = [&](const string& RE, const Membership& accepted) { return MergeNode{ RE, accepted, allPos, allNeg }; };
+
+     auto consistent = [&](const Membership& accepted) {
+         return withMembership(allPos, accepted.pos, false).empty() && withMembership(allNeg, accepted.neg, true).empty();
+     };
+     if (consistent(l.accepted)) return node(l.RE, l.accepted);
+     if (consistent(r.accepted)) return node(r.RE, r.accepted);
+
+     // The RE of a node that rejects all the negatives
+     auto patched = [&](const MergeNode& n, const vector<int>& otherNeg, const vector<int>& patchPos) {
+         vector<int> acceptedNeg = withMembership(otherNeg, n.accepted.neg, true);
+         if (acceptedNeg.empty()) return std::make_pair(n.RE, n.accepted);
+
+         MergeNode patch = run.solve(patchPos, acceptedNeg, profileInfo);
+         if (withMembership(indexDifference(allNeg, acceptedNeg), patch.accepted.neg, true).empty())
+             return std::make_pair(patch.RE, patch.accepted);
+         // intersect makes an optional of the other RE when one of them is eps, what it accepts is not the one of both then
+         string combined = intersect(n.RE, patch.RE);
+         if (n.RE == "eps" || patch.RE == "eps") return std::make_pair(combined, matchPool(combined, run.pos, run.neg, profileInfo));
+         return std::make_pair(combined, both(n.accepted, patch.accepted));
+     };
+
+     auto [left, leftAccepted] = patched(l, r.neg, l.pos);
+
+     vector<int> uncovered = withMembership(r.pos, leftAccepted.pos, false);
+     if (uncovered.empty()) return node(left, leftAccepted);
+
+     auto [right, rightAccepted] = patched(r, l.neg, uncovered);
+     if (withMembership(allPos, rightAccepted.pos, false).empty()) return node(right, rightAccepted);
+
+     return node(alternation(left, right), either(leftAccepted, rightAccepted));
+ }
+
+ void addProfile(paresy_s::RecursiveProfileInfo& into, const paresy_s::RecursiveProfileInfo& from, int depth) {
+     into.callCount += from.callCount;
+     into.maxDepth = std::max(into.maxDepth, depth + from.maxDepth);
+     into.matchCalls += from.matchCalls;
+     into.exhaustiveMatchCalls += from.exhaustiveMatchCalls;
+ }
+
+ string paresy_s::mergeSplit(int window, const unsigned short* costFun, const unsigned short maxCost,
+     const vector<string>& pos, const vector<string>& neg, double maxTime, RecursiveProfileInfo& profileInfo, const LeafSolver& solver,
+     int threads) {
+
+     profileInfo.enter();
+
+     ICProjection ic(pos, neg);
+     MergeRun run{ ic, window, costFun, maxCost, pos, neg, maxTime, solver };
+
+     // Dealing the examples round-robin, so every leaf has positives and negatives when there are any
+     size_t leafCount = std::max<size_t>(1, (pos.size() + neg.size() + window - 1) / window);
+     if (!pos.empty() && !neg.empty()) leafCount = std::min({ leafCount, pos.size(), neg.size() });
+
+     vector<vector<int>> leafPos(leafCount), leafNeg(leafCount);
+     for (size_t i = 0; i < pos.size(); ++i) leafPos[i % leafCount].push_back(static_cast<int>(i));
+     for (size_t i = 0; i < neg.size(); ++i) leafNeg[i % leafCount].push_back(static_cast<int>(i));
+
+ #if LOG_LEVEL >= 1
+     printf("=== merge split, leaves: %u, pos: %u, neg: %u ===\n", (int)leafCount, (int)pos.size(), (int)neg.size());
+ #endif
+
+     WorkerPool pool(threads);
+
+     vector<MergeNode> level(leafCount);
+     vector<RecursiveProfileInfo> profiles(leafCount);
+     // The leaves that run at once split the memory and the threads of an enumeration, out of the share of
+     // this thread when mergeSplit is itself one of several
+     int inherited = ResourceShare::parts();
+     int parts = std::min(pool.size(), static_cast<int>(leafCount));
+     pool.run(static_cast<int>(leafCount), [&](int i) {
+         ResourceShare share(inherited, parts);
+         level[i] = run.solve(leafPos[i], leafNeg[i], profiles[i]);
+     });
+
+     int depth = 1;
+     for (auto& leaf : profiles) addProfile(profileInfo, leaf, depth);
+
+     // A level of the tree at a time, the pairs of a level are merged in parallel
+     while (level.size() > 1) {
+         ++depth;
+         size_t pairs = level.size() / 2;
+
+         vector<MergeNode> next(pairs);
+         profiles.assign(pairs, RecursiveProfileInfo());
+         parts = std::min(pool.size(), static_cast<int>(pairs));
+         pool.run(static_cast<int>(pairs), [&](int i) {
+             ResourceShare share(inherited, parts);
+             next[i] = merge(run, level[2 * i], level[2 * i + 1], profiles[i]);
+         });
+
+         for (auto& merged : profiles) addProfile(profileInfo, merged, depth);
+         if (level.size() % 2 == 1) next.push_back(std::move(level.back()));
+         level.swap(next);
+
+ #if LOG_LEVEL >= 1
+         printf("merged into %u nodes\n", (int)level.size());
+ #endif
+     }
+
+     return level.front().RE;
+ }
+
+ std::future<string> paresy_s::reoptimizeInBackground(int window, const unsigned short* costFun, const unsigned short maxCost,
+     vector<string> pos, vector<string> neg, double maxTime, const LeafSolver& solver) {
+
+     // detSplit keeps no state between the calls, unlike the sampling of randSplit
+     std::array<unsigned short, 6> costs;
+     std::copy(costFun, costFun + 6, costs.begin());
+
+     return std::async(std::launch::async, [=, pos = std::move(pos), neg = std::move(neg)]() {
+         RecursiveProfileInfo profileInfo;
+         return detSplit(window, costs.data(), maxCost, pos, neg, maxTime, profileInfo, solver);
+     });
  }
\ No newline at end of file
@@ -0,0 +1,1123 @@
+#include <rei_host.hpp>
+
+#include <climits>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <unordered_map>
+#include <thread>
+
+#include <pair_mapping.h>
+#include <tile_scheduler.h>
+#include <worker_pool.hpp>
+#include <re_string.hpp>
+#include <bit_sliced.hpp>
+#include <seed_atoms.hpp>
+#include <meet_in_the_middle.hpp>
+#include <checkpoint.hpp>
+#include <cost_batch.hpp>
+
+using paresy_s::Opreation;
+using paresy_s::Costs;
+using paresy_s::CostIntervals;
+using paresy_s::HostContext;
+using paresy_s::HostGuideTable;
+using paresy_s::BitSlicedBatch;
+using paresy_s::checkTime;
+using paresy_s::Checkpoint;
+using paresy_s::SolutionSet;
+using paresy_s::ExtraAtoms;
+
+#ifndef HOST_MEMORY
+#define HOST_MEMORY 4096
+#endif
+
+#ifndef CHECKPOINT_DIR
+#define CHECKPOINT_DIR ""
+#endif
+
+#if LOG_LEVEL == 3
+#define LOG_OP(context, cost, op_string, dif) \
+        int tbc = dif; \
+        if (tbc) printf("Cost %-2d | (%s) | AllREs: %-11llu | StoredREs: %-10d | ToBeChecked: %-10d \n", \
+            cost, op_string.c_str(), (unsigned long long)context.allREs, (int)context.lastIdx, tbc);
+#else
+#define LOG_OP(context, cost, op_string, dif)
+#endif
+
+#ifndef HOST_THREADS
+#define HOST_THREADS 0
+#endif
+
+// Candidates in a unit of work of the pool, the operands of a tile of this size stay in the cache of a core
+const int hostTilePairs = 1 << 12;
+// Units per thread between two insertions into the language cache
+const int hostWindowFactor = 4;
+// The levels after the current one whose ready launches fill the idle threads,
+// and the windows of their results that can wait in memory
+const int hostLookaheadLevels = 2;
+const int hostLookaheadWindows = 4;
+
+// The part of the REs that stay in memory when the language cache spills to disk
+const int hostHotFraction = 4;
+
+// ============= guide table =============
+
+HostGuideTable::HostGuideTable(const std::set<std::string, strComparison>& ic)
+{
+    std::unordered_map<std::string, int> index;
+    for (auto& word : ic) {
+        if (word.size() == 1) alphabetSize++;
+        index.emplace(word, static_cast<int>(index.size()));
+    }
+
+    ICsize = static_cast<int>(ic.size());
+
+    for (auto& word : ic) {
+        rowStart.push_back(static_cast<int>(splits.size()));
+        for (size_t i = 1; i < word.length(); ++i)
+            splits.push_back({ index[word.substr(0, i)], index[word.substr(i)] });
+    }
+    rowStart.push_back(static_cast<int>(splits.size()));
+}
+
+HostGuideTable HostGuideTable::project(const paresy_s::WordSelection& selection) const
+{
+    HostGuideTable projected;
+    projected.ICsize = selection.count();
+
+    for (int ix = 0; ix < ICsize; ++ix) {
+        if (selection.block(ix) == 0) { ix += 63 - ix % 64; continue; }
+        if (!selection.test(ix)) continue;
+
+        if (ix >= 1 && ix <= alphabetSize) projected.alphabetSize++;
+        projected.rowStart.push_back(static_cast<int>(projected.splits.size()));
+        for (auto split = rowBegin(ix); split != rowEnd(ix); ++split)
+            projected.splits.push_back({ selection.rank(split->left), selection.rank(split->right) });
+    }
+    projected.rowStart.push_back(static_cast<int>(projected.splits.size()));
+
+    return projected;
+}
+
+// ============= operations =============
+
+CS paresy_s::hostQuestion(const CS& cs) {
+    return cs | CS::one();
+}
+
+// Single CSs, for the REs that are not enumerated. The batches of the enumeration are in bit_sliced.cpp
+
+CS paresy_s::hostStar(const HostGuideTable& guideTable, const CS& cs) {
+
+    CS star = cs | CS::one();
+
+    // the splits of a word only point to shorter words, which are already closed
+    for (int ix = guideTable.alphabetSize + 1; ix < guideTable.ICsize; ++ix) {
+        for (auto split = guideTable.rowBegin(ix); split != guideTable.rowEnd(ix) && !star.test(ix); ++split)
+            if (star.test(split->left) && star.test(split->right)) star.set(ix);
+    }
+
+    return star;
+}
+
+CS paresy_s::hostConcatenate(const HostGuideTable& guideTable, const CS& left, const CS& right) {
+
+    // when one side contains epsilon, the other side is part of the result
+    CS result;
+    if (left.test(0)) result |= right;
+    if (right.test(0)) result |= left;
+
+    for (int ix = guideTable.alphabetSize + 1; ix < guideTable.ICsize; ++ix) {
+        for (auto split = guideTable.rowBegin(ix); split != guideTable.rowEnd(ix) && !result.test(ix); ++split)
+            if (left.test(split->left) && right.test(split->right)) result.set(ix);
+    }
+
+    return result;
+}
+
+// ============= Context =============
+
+HostContext::HostContext(uint64_t capacity, CS posBits, CS negBits)
+    : capacity(capacity), allREs(0), lastIdx(0), isFound(false), onTheFly(false),
+    finalLeftIdx(-1), finalRightIdx(-1), checkedCost(0), checkedOp(Opreation::Concatenate),
+    posBits(posBits), negBits(negBits), solution(posBits, negBits)
+{
+}
+
+uint64_t HostContext::getCacheCapacity(uint64_t memorySize) {
+    // the CS with its indices, and its copy in the hash set with the node and the bucket
+    return memorySize / (sizeof(CS) * 2 + sizeof(int) * 2 + sizeof(void*) * 2);
+}
+
+Pair<uint64_t> HostContext::getTieredCapacity(uint64_t memorySize, uint64_t diskSize) {
+    // the hash of a spilled CS and its indices stay in memory
+    uint64_t resident = sizeof(paresy_s::VisitedSet::value_type) + sizeof(int) * 2 + sizeof(void*) * 2;
+    uint64_t capacity = memorySize / (resident + sizeof(CS) / hostHotFraction);
+    uint64_t hot = capacity / hostHotFraction;
+    uint64_t cold = std::min(capacity - hot, diskSize / sizeof(CS));
+
+    // a small file doesn't pay for the memory that the hot part gives up
+    uint64_t inMemory = getCacheCapacity(memorySize);
+    if (hot + cold <= inMemory) return { inMemory, inMemory };
+    return { hot + cold, hot };
+}
+
+int64_t HostContext::reserve(const CS& cs, int ldx, int rdx) {
+
+    if (onTheFly || visited.insert(cs).second) {
+
+        if (isSolution(cs)) {
+            if (!SolutionSet::collecting) {
+                finalLeftIdx = ldx; finalRightIdx = rdx;
+                isFound = true;
+                return -1;
+            }
+            // a collected solution is stored like the other REs, unless the set is full
+            auto [high, low] = cs.get128Hash();
+            isFound = solutions.add(high, low, { ldx, rdx, checkedCost, checkedOp });
+            if (isFound) return -1;
+        }
+
+        if (onTheFly) return -1;
+
+        // If language cache gets full, it makes onTheFly mode on
+        if (lastIdx == capacity) {
+            onTheFly = true;
+            visited.clear();
+#if LOG_LEVEL >= 2
+            printf("==== switch to \"OnTheFly\" ====\n");
+#endif
+            return -1;
+        }
+
+        return static_cast<int64_t>(lastIdx++);
+    }
+
+    return -1;
+}
+
+bool HostContext::insert(const CS& cs, int ldx, int rdx) {
+
+    if (reserve(cs, ldx, rdx) >= 0) {
+        langCache.push_back(cs);
+        leftIdx.push_back(ldx);
+        rightIdx.push_back(rdx);
+    }
+
+    return isFound;
+}
+
+bool HostContext::intialCheck(const std::vector<std::string>& pos, const std::vector<std::string>& neg,
+    const AlphabetClasses& classes, std::string& RE)
+{
+    // Initialisation of the alphabet
+    for (auto& word : pos) for (auto ch : word) alphabet.insert(ch);
+    for (auto& word : neg) for (auto ch : word) alphabet.insert(ch);
+    for (auto ch : alphabet) atoms.push_back(classes.expand(ch));
+
+    // Checking empty
+    allREs++;
+    if (pos.empty()) { RE = "Empty"; return true; }
+
+    // Checking epsilon
+    allREs++;
+    if ((pos.size() == 1) && (pos.at(0).empty())) { RE = "eps"; return true; }
+
+    visited.insert(CS());
+    visited.insert(CS::one());
+
+    // Checking the alphabet, its first char is at index 1 (idx 0 is for epsilon)
+    for (int i = 0; i < static_cast<int>(alphabet.size()); ++i) {
+
+        allREs++;
+
+        std::string s(1, *next(alphabet.begin(), i));
+        if ((pos.size() == 1) && (pos.at(0) == s)) { RE = atoms[i]; return true; }
+
+        CS cs; cs.set(i + 1);
+        visited.insert(cs);
+        langCache.push_back(cs);
+        leftIdx.push_back(-1);
+        rightIdx.push_back(-1);
+        lastIdx++;
+    }
+
+    return false;
+}
+
+// Following the left and right indices down from the solution
+std::string HostContext::REtoString(const CostIntervals& intervals) const
+{
+    paresy_s::Provenance provenance({ { finalLeftIdx, finalRightIdx } }, static_cast<int>(atoms.size()), leftIdx.data(), rightIdx.data());
+    return paresy_s::toString(paresy_s::Provenance::finalIndex, provenance, atoms, classAtoms, intervals);
+}
+
+std::vector<paresy_s::Solution> HostContext::solutionStrings(const CostIntervals& intervals) const
+{
+    std::vector<Pair<int>> roots;
+    for (auto& found : solutions.all()) roots.push_back({ found.left, found.right });
+    paresy_s::Provenance provenance(roots, static_cast<int>(atoms.size()), leftIdx.data(), rightIdx.data());
+    return paresy_s::toStrings(solutions.all(), provenance, atoms, classAtoms, intervals);
+}
+
+// ============= launches =============
+
+// Host counterparts of the kernels. Each one evaluates a unit of the work into its own results,
+// the units of a launch run on the worker pool and only read the context
+
+namespace {
+
+    // The new CSs of a unit with their indices, in the order of their tid
+    struct TileResults {
+
+        void clear() { css.clear(); leftIdx.clear(); rightIdx.clear(); candidates = 0; }
+
+        // The CSs that are already in the language cache are dropped here, in parallel.
+        // In "OnTheFly" mode nothing is stored, so only the solutions are kept
+        void push(const HostContext& context, const CS& cs, int ldx, int rdx) {
+            if (context.onTheFly ? !context.isSolution(cs) : context.visited.count(cs) > 0) return;
+            css.push_back(cs);
+            leftIdx.push_back(ldx);
+            rightIdx.push_back(rdx);
+        }
+
+        std::vector<CS> css;
+        std::vector<int> leftIdx, rightIdx;
+        uint64_t candidates = 0;
+    };
+
+    enum class LaunchStatus { Done, Found, TimeOut };
+
+}
+
+// The number of units of an interval for the unary operations
+int unitCount(int size) { return (size + hostTilePairs - 1) / hostTilePairs; }
+
+Pair<int> unitInterval(Pair<int> interval, int unit) {
+    int start = interval.left + unit * hostTilePairs;
+    return { start, std::min(start + hostTilePairs, interval.right) };
+}
+
+void QuestionMark(const HostContext& context, Pair<int> interval, TileResults& results)
+{
+    results.candidates = interval.right - interval.left;
+    for (int tid = 0; tid < interval.right - interval.left; ++tid) {
+        CS cs = paresy_s::hostQuestion(context.langCache[interval.left + tid]);
+        results.push(context, cs, interval.left + tid, 0);
+    }
+}
+
+// Star and concatenation work on bit-sliced batches of candidates
+
+void Star(const HostContext& context, const HostGuideTable& guideTable, Pair<int> interval, TileResults& results)
+{
+    const int batchWidth = BitSlicedBatch::width;
+    BitSlicedBatch batch(guideTable.ICsize);
+    int indices[batchWidth];
+    CS stars[batchWidth];
+
+    results.candidates = interval.right - interval.left;
+    for (int first = 0; first < interval.right - interval.left; first += batchWidth) {
+
+        int count = std::min(batchWidth, interval.right - interval.left - first);
+        for (int k = 0; k < count; ++k) indices[k] = interval.left + first + k;
+
+        batch.load(context.langCache, indices, count);
+        paresy_s::slicedStar(guideTable, batch);
+        batch.store(stars, count);
+
+        for (int k = 0; k < count; ++k) results.push(context, stars[k], interval.left + first + k, 0);
+    }
+}
+
+void Concat(const HostContext& context, const HostGuideTable& guideTable, const paresy_s::Tile& tile, TileResults& results)
+{
+    int width = tile.right.right - tile.right.left;
+    int N = tile.size();
+
+    const int batchWidth = BitSlicedBatch::width;
+    BitSlicedBatch left(guideTable.ICsize), right(guideTable.ICsize), lr(guideTable.ICsize), rl(guideTable.ICsize);
+    int lIndices[batchWidth];
+    int rIndices[batchWidth];
+    CS lrResults[batchWidth], rlResults[batchWidth];
+
+    context.langCache.prefetch(tile.left);
+    context.langCache.prefetch(tile.right);
+
+    results.candidates = 2 * static_cast<uint64_t>(N);
+    for (int first = 0; first < N; first += batchWidth) {
+
+        int count = std::min(batchWidth, N - first);
+        for (int k = 0; k < count; ++k) {
+            lIndices[k] = tile.left.left + (first + k) / width;
+            rIndices[k] = tile.right.left + (first + k) % width;
+        }
+
+        left.load(context.langCache, lIndices, count);
+        right.load(context.langCache, rIndices, count);
+        paresy_s::slicedConcatenate(guideTable, left, right, lr, rl);
+        lr.store(lrResults, count);
+        rl.store(rlResults, count);
+
+        for (int k = 0; k < count; ++k) {
+            results.push(context, lrResults[k], lIndices[k], rIndices[k]);
+            results.push(context, rlResults[k], rIndices[k], lIndices[k]);
+        }
+    }
+}
+
+void OrEpsilon(const HostContext& context, Pair<int> interval, TileResults& results)
+{
+    results.candidates = interval.right - interval.left;
+    for (int tid = 0; tid < interval.right - interval.left; ++tid) {
+        CS cs = context.langCache[interval.left + tid] | CS::one();
+        results.push(context, cs, interval.left + tid, -2);
+    }
+}
+
+// Or and And of every pair of a tile. In "OnTheFly" mode only the words with examples are read first
+template <class Op>
+void CrossProduct(const HostContext& context, const paresy_s::Tile& tile, Op op, TileResults& results)
+{
+    context.langCache.prefetch(tile.left);
+    context.langCache.prefetch(tile.right);
+
+    results.candidates = tile.size();
+    for (int ldx = tile.left.left; ldx < tile.left.right; ++ldx) {
+        const CS& left = context.langCache[ldx];
+        for (int rdx = tile.right.left; rdx < tile.right.right; ++rdx) {
+            if (context.onTheFly && !paresy_s::maybeSolution(context.langCache, ldx, rdx, context.solution, op)) continue;
+            results.push(context, op(left, context.langCache[rdx]), ldx, rdx);
+        }
+    }
+}
+
+// Or and And of the pairs x < y of one interval, from the pair number firstPair on
+template <class Op>
+void Triangle(const HostContext& context, Pair<int> interval, uint64_t firstPair, int N, Op op, TileResults& results)
+{
+    results.candidates = N;
+    for (int tid = 0; tid < N; ++tid) {
+        auto [x, y] = paresy_s::triangularIndex(firstPair + tid);
+        int ldx = interval.left + x;
+        int rdx = interval.left + y;
+        if (context.onTheFly && !paresy_s::maybeSolution(context.langCache, ldx, rdx, context.solution, op)) continue;
+        results.push(context, op(context.langCache[ldx], context.langCache[rdx]), ldx, rdx);
+    }
+}
+
+// A launch of one phase of a cost level, split into units that are evaluated independently
+struct Launch {
+    Opreation op;
+    int count;
+    std::function<void(int, TileResults&)> eval;
+    // The pairs of Or and And, they are skipped once the cache is full if the lookups have covered them
+    bool pairs;
+};
+
+// A launch before its operands are known, it is made once the levels it reads are sealed
+struct LaunchSpec {
+    // The most expensive level that the launch reads
+    int inputCost;
+    std::function<Launch()> make;
+};
+
+// Evaluating the launches of the cost levels on the pool as soon as the levels they read are sealed.
+// The windows are filled with the units of the current level first, and the rest of them with the
+// units of the next levels that are ready already, so the pool doesn't wait for the tail of a level.
+// Only the results of the current level are inserted, in the order of its launches and their units like
+// running them one after another. So the sub-intervals of a level don't depend on the threads, and no
+// solution of a level is seen before all the cheaper levels have been checked
+class DataflowScheduler {
+public:
+    DataflowScheduler(int threads, int lastReadCost, std::chrono::steady_clock::time_point startTime, double maxTime)
+        : pool(threads), windowSize(hostWindowFactor * pool.size()), lastReadCost(lastReadCost), startTime(startTime), maxTime(maxTime) {}
+
+    // Adding the next cost level, with its launches in the order of the phases
+    void addLevel(int cost, std::vector<LaunchSpec> specs) {
+        Level level;
+        level.cost = cost;
+        level.launches.resize(specs.size());
+        for (size_t j = 0; j < specs.size(); ++j) level.launches[j].spec = std::move(specs[j]);
+        levels.push_back(std::move(level));
+    }
+
+    // Runs the windows until the current level is inserted as a whole and sealed, the end of every phase is set
+    // in the intervals as its last result is inserted. On a solution, the end of its phase is set to INT_MAX
+    LaunchStatus run(HostContext& context, CostIntervals& intervals, bool skipPairs)
+    {
+        std::vector<std::pair<LaunchState*, int>> window; // (launch, unit)
+
+        while (true) {
+
+            if (insertReady(context, intervals, skipPairs)) return LaunchStatus::Found;
+            if (levels.front().next == levels.front().launches.size()) {
+                for (; levels.front().phase <= static_cast<int>(Opreation::And); ++levels.front().phase)
+                    intervals.end(levels.front().cost, static_cast<Opreation>(levels.front().phase)) = context.lastIdx;
+                levels.pop_front();
+                return LaunchStatus::Done;
+            }
+
+            fillWindow(context, window, skipPairs);
+
+            pool.run(static_cast<int>(window.size()), [&](int k) {
+                auto& [launch, unit] = window[k];
+                launch->launch.eval(unit, *launch->results[unit]);
+            });
+
+            if (checkTime(startTime, maxTime)) return LaunchStatus::TimeOut;
+        }
+    }
+
+private:
+    struct LaunchState {
+        LaunchSpec spec;
+        Launch launch;
+        bool made = false;
+        bool started = false;
+        // It is skipped as a whole, this is decided before its first result is inserted
+        bool dropped = false;
+        int issued = 0;
+        int inserted = 0;
+        // The results of the issued units that are not inserted yet
+        std::vector<std::unique_ptr<TileResults>> results;
+    };
+
+    // The new REs of a unit that wait to be copied into the language cache
+    struct Copy {
+        const TileResults* results;
+        uint64_t first;
+        size_t count;
+    };
+
+    struct Level {
+        int cost;
+        std::vector<LaunchState> launches;
+        // The launch that is being inserted, and the next phase to be closed
+        size_t next = 0;
+        int phase = static_cast<int>(Opreation::Question);
+    };
+
+    // Every level cheaper than the current one is sealed
+    int sealed() const { return levels.front().cost - 1; }
+
+    bool make(LaunchState& state) {
+        if (!state.made && state.spec.inputCost <= sealed()) {
+            state.launch = state.spec.make();
+            state.results.resize(state.launch.count);
+            state.made = true;
+        }
+        return state.made;
+    }
+
+    // The pairs are only needed for their REs when they aren't stored, or nothing reads their level
+    bool skipped(const HostContext& context, const Level& level, const Launch& launch, bool skipPairs) const {
+        return launch.pairs && skipPairs && (context.onTheFly || level.cost > lastReadCost);
+    }
+
+    void fillWindow(const HostContext& context, std::vector<std::pair<LaunchState*, int>>& window, bool skipPairs)
+    {
+        window.clear();
+
+        int buffered = 0;
+        for (size_t l = 1; l < levels.size(); ++l)
+            for (auto& state : levels[l].launches) buffered += state.issued;
+
+        for (auto& level : levels) {
+            bool ahead = &level != &levels.front();
+            for (size_t j = ahead ? 0 : level.next; j < level.launches.size(); ++j) {
+
+                auto& state = level.launches[j];
+                if (!make(state) || state.dropped || (state.issued == 0 && skipped(context, level, state.launch, skipPairs))) continue;
+
+                while (state.issued < state.launch.count && static_cast<int>(window.size()) < windowSize) {
+                    // the results of the next levels wait in memory, so only a few windows of them are kept
+                    if (ahead && buffered >= hostLookaheadWindows * windowSize) return;
+                    window.emplace_back(&state, state.issued);
+                    state.results[state.issued++] = acquire();
+                    if (ahead) buffered++;
+                }
+                if (static_cast<int>(window.size()) == windowSize) return;
+            }
+        }
+    }
+
+    // Inserting the results of the current level that are next in order
+    bool insertReady(HostContext& context, CostIntervals& intervals, bool skipPairs)
+    {
+        auto& level = levels.front();
+
+        for (; level.next < level.launches.size(); ++level.next) {
+
+            auto& state = level.launches[level.next];
+            make(state);
+
+            if (!state.started) {
+                state.started = true;
+                for (; level.phase < static_cast<int>(state.launch.op); ++level.phase)
+                    intervals.end(level.cost, static_cast<Opreation>(level.phase)) = context.lastIdx;
+                // the cache may have got full in the previous launches
+                state.dropped = skipped(context, level, state.launch, skipPairs);
+            }
+
+            for (; state.inserted < state.launch.count && (state.dropped || state.results[state.inserted]); ++state.inserted) {
+
+                auto results = std::move(state.results[state.inserted]);
+                if (!results) continue;
+
+                if (!state.dropped) {
+                    context.allREs += results->candidates;
+                    context.checkedCost = level.cost;
+                    context.checkedOp = state.launch.op;
+                    if (compact(context, *results)) {
+                        store(context);
+                        intervals.setFinal(level.cost, state.launch.op);
+                        return true;
+                    }
+                }
+                release(std::move(results));
+            }
+
+            if (state.inserted < state.launch.count) break;
+            state.results.clear();
+        }
+
+        store(context);
+        return false;
+    }
+
+    // Checking the results of a unit in order, the new REs are moved to its front and get the next positions
+    // of the language cache. They are copied into it by store, so only the uniqueness check is serial
+    bool compact(HostContext& context, TileResults& results)
+    {
+        uint64_t first = context.lastIdx;
+        size_t kept = 0;
+        for (size_t k = 0; k < results.css.size(); ++k) {
+            if (context.reserve(results.css[k], results.leftIdx[k], results.rightIdx[k]) < 0) {
+                if (context.isFound) break;
+                continue;
+            }
+            results.css[kept] = results.css[k];
+            results.leftIdx[kept] = results.leftIdx[k];
+            results.rightIdx[kept] = results.rightIdx[k];
+            kept++;
+        }
+
+        if (kept) copies.push_back({ &results, first, kept });
+        return context.isFound;
+    }
+
+    // Copying the compacted units into the positions that they have reserved, on the pool
+    void store(HostContext& context)
+    {
+        if (copies.empty()) return;
+
+        context.langCache.resize(context.lastIdx);
+        context.leftIdx.resize(context.lastIdx);
+        context.rightIdx.resize(context.lastIdx);
+
+        pool.run(static_cast<int>(copies.size()), [&](int k) {
+            auto& copy = copies[k];
+            context.langCache.write(copy.first, copy.results->css.data(), copy.count);
+            std::copy_n(copy.results->leftIdx.begin(), copy.count, context.leftIdx.begin() + copy.first);
+            std::copy_n(copy.results->rightIdx.begin(), copy.count, context.rightIdx.begin() + copy.first);
+        });
+        copies.clear();
+    }
+
+    std::unique_ptr<TileResults> acquire() {
+        if (spare.empty()) return std::make_unique<TileResults>();
+        auto results = std::move(spare.back());
+        spare.pop_back();
+        results->clear();
+        return results;
+    }
+
+    void release(std::unique_ptr<TileResults> results) { spare.push_back(std::move(results)); }
+
+    paresy_s::WorkerPool pool;
+    int windowSize;
+    int lastReadCost;
+    std::deque<Level> levels;
+    // The results are kept between the windows to reuse their memory
+    std::vector<std::unique_ptr<TileResults>> spare;
+    // The released results of the copies are not reused before they are stored
+    std::vector<Copy> copies;
+    std::chrono::steady_clock::time_point startTime;
+    double maxTime;
+};
+
+const paresy_s::OrOp orOp;
+const paresy_s::AndOp andOp;
+
+// Or and And of the pairs x < y of one interval, in units of hostTilePairs pairs
+template <class Op>
+Launch TriangleLaunch(const HostContext& context, Opreation op, Pair<int> interval, Op opFun)
+{
+    uint64_t pairs = paresy_s::triangularCount(interval.right - interval.left);
+    return { op, static_cast<int>((pairs + hostTilePairs - 1) / hostTilePairs), [&context, interval, pairs, opFun](int unit, TileResults& results) {
+        uint64_t first = static_cast<uint64_t>(unit) * hostTilePairs;
+        Triangle(context, interval, first, static_cast<int>(std::min<uint64_t>(hostTilePairs, pairs - first)), opFun, results);
+    }, true };
+}
+
+// The character classes and the seeds of a level
+void Atoms(const HostContext& context, const ExtraAtoms& atoms, Pair<int> level, TileResults& results)
+{
+    results.candidates = level.right - level.left;
+    for (int i = level.left; i < level.right; ++i) results.push(context, atoms.css[i], -3 - i, -3 - i);
+}
+
+bool seedAtoms(HostContext& context, const ExtraAtoms& atoms, Pair<int> level)
+{
+    context.allREs += level.right - level.left;
+    for (int i = level.left; i < level.right; ++i)
+        if (context.insert(atoms.css[i], -3 - i, -3 - i)) return true;
+    return false;
+}
+
+#ifdef MEET_IN_THE_MIDDLE
+// The projections of the language cache onto the examples, see rei.cu
+struct HostProjections {
+
+    HostProjections(const CS& posBits, const CS& negBits, int ICsize) {
+        for (int i = 0; i < ICsize; ++i) {
+            if (posBits.test(i)) posIndices.push_back(i);
+            if (negBits.test(i)) negIndices.push_back(i);
+        }
+    }
+
+    bool fits() const { return posIndices.size() <= 64 && negIndices.size() <= 64; }
+
+    void update(const HostContext& context) {
+        for (auto i = projections.size(); i < context.lastIdx; ++i)
+            projections.push_back(paresy_s::projectCS(context.langCache[i], posIndices.data(), static_cast<int>(posIndices.size()),
+                negIndices.data(), static_cast<int>(negIndices.size())));
+    }
+
+    std::vector<int> posIndices, negIndices;
+    std::vector<paresy_s::Projection> projections;
+};
+
+bool meetInTheMiddle(HostContext& context, HostProjections& projections, const CostIntervals& intervals, const Costs& costs, int cost, Opreation& op)
+{
+    projections.update(context);
+
+    auto posCount = static_cast<int>(projections.posIndices.size());
+    auto negCount = static_cast<int>(projections.negIndices.size());
+
+    for (int i = costs.alpha; 2 * i <= cost - costs.alternation; ++i) {
+        auto [lstart, lend] = intervals.Interval(i);
+        auto [rstart, rend] = intervals.Interval(cost - i - costs.alternation);
+        auto found = paresy_s::findAlternation(projections.projections.data(), Pair<int>(lstart, lend), Pair<int>(rstart, rend), posCount);
+        if (found.left != -1) {
+            context.finalLeftIdx = found.left; context.finalRightIdx = found.right; context.isFound = true;
+            op = Opreation::Or; return true;
+        }
+    }
+
+    for (int i = costs.alpha; 2 * i <= cost - costs.intersection; ++i) {
+        auto [lstart, lend] = intervals.Interval(i);
+        auto [rstart, rend] = intervals.Interval(cost - i - costs.intersection);
+        auto found = paresy_s::findIntersection(projections.projections.data(), Pair<int>(lstart, lend), Pair<int>(rstart, rend), posCount, negCount);
+        if (found.left != -1) {
+            context.finalLeftIdx = found.left; context.finalRightIdx = found.right; context.isFound = true;
+            op = Opreation::And; return true;
+        }
+    }
+
+    return false;
+}
+#endif
+
+// ============= REI =============
+
+// The result of the collected solutions. They are made of the levels that are cheaper than cost,
+// the start points after them are set like after a single solution
+paresy_s::Result solutionsResult(const HostContext& context, CostIntervals& intervals, int cost, int ICsize)
+{
+    intervals.setFinal(cost - 1, Opreation::And);
+    auto solutions = context.solutionStrings(intervals);
+    paresy_s::Result result(solutions.front().RE, solutions.front().REcost, context.allREs, ICsize);
+    result.solutions = std::move(solutions);
+    return result;
+}
+
+paresy_s::HostExamples::HostExamples(const std::vector<std::string>& pos, const std::vector<std::string>& neg)
+    : fits(false), posBits{}, negBits{}
+{
+    std::set<std::string, strComparison> ic = generatingIC(pos, neg);
+    if (ic.size() > sizeof(CS) * 8) {
+#if LOG_LEVEL >= 2
+        printf("Your input needs %lu bits which exceeds %lu bits ", ic.size(), sizeof(CS) * 8);
+        printf("(current version).\nPlease use less/shorter words and run the code again.\n");
+#endif
+        return;
+    }
+
+    guideTable = HostGuideTable(ic);
+    for (auto& p : pos) posBits.set(static_cast<int>(distance(ic.begin(), ic.find(p))));
+    for (auto& n : neg) negBits.set(static_cast<int>(distance(ic.begin(), ic.find(n))));
+    fits = true;
+}
+
+paresy_s::HostExamples::HostExamples(HostGuideTable guideTable, CS posBits, CS negBits)
+    : fits(guideTable.ICsize <= static_cast<int>(sizeof(CS) * 8)), guideTable(std::move(guideTable)), posBits(posBits), negBits(negBits)
+{
+}
+
+namespace {
+    thread_local int shareParts = 1;
+}
+
+paresy_s::ResourceShare::ResourceShare(int parts) : ResourceShare(shareParts, parts) {}
+
+paresy_s::ResourceShare::ResourceShare(int inherited, int parts) : previous(shareParts)
+{
+    shareParts = std::max(1, inherited) * std::max(1, parts);
+}
+
+paresy_s::ResourceShare::~ResourceShare()
+{
+    shareParts = previous;
+}
+
+int paresy_s::ResourceShare::parts()
+{
+    return shareParts;
+}
+
+paresy_s::Result paresy_s::hostEnumerate(const unsigned short* costFun, const unsigned short maxCost, const std::vector<std::string>& pos, const std::vector<std::string>& neg,
+    double maxTime, const AlphabetClasses& classes, const std::vector<Seed>& seeds, bool checkpoint) {
+    return hostEnumerate(HostExamples(pos, neg), costFun, maxCost, pos, neg, maxTime, classes, seeds, checkpoint);
+}
+
+paresy_s::Result paresy_s::hostEnumerate(const HostExamples& examples, const unsigned short* costFun, const unsigned short maxCost,
+    const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime, const AlphabetClasses& classes,
+    const std::vector<Seed>& seeds, bool checkpoint) {
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    Costs costs(costFun);
+
+    if (!examples.fits) return Result("not_found", 0, 0, 0);
+
+    const HostGuideTable& guideTable = examples.guideTable;
+    const CS& posBits = examples.posBits;
+    const CS& negBits = examples.negBits;
+
+    // A leaf that runs along with others takes its part of the budget
+    int share = paresy_s::ResourceShare::parts();
+    uint64_t available_memory = (uint64_t)HOST_MEMORY * 1024 * 1024 / share;
+#if HOST_DISK > 0
+    auto [langCacheCapacity, hotCapacity] = HostContext::getTieredCapacity(available_memory, (uint64_t)HOST_DISK * 1024 * 1024 / share);
+#else
+    uint64_t langCacheCapacity = HostContext::getCacheCapacity(available_memory);
+#endif
+
+#if LOG_LEVEL >= 2
+    printf("The amount of memory that will be used: %lf mb.\n", available_memory / ((double)1024 * 1024));
+    printf("The max amount of RE that will be stored: %lu. The ICSize is %u\n", langCacheCapacity, guideTable.ICsize);
+#endif
+
+    HostContext context(langCacheCapacity, posBits, negBits);
+#if HOST_DISK > 0
+    if (hotCapacity < langCacheCapacity && !context.langCache.open(hotCapacity, langCacheCapacity - hotCapacity)) {
+#if LOG_LEVEL >= 2
+        printf("Unable to create the spill file, the language cache stays in memory\n");
+#endif
+        context.capacity = HostContext::getCacheCapacity(available_memory);
+    }
+#endif
+    CostIntervals intervals(maxCost);
+    int threads = HOST_THREADS > 0 ? HOST_THREADS : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    DataflowScheduler scheduler(std::max(1, threads / share), paresy_s::lastReadCost(costs, maxCost), startTime, maxTime);
+
+    std::string RE;
+
+    if (context.intialCheck(pos, neg, classes, RE)) return Result(RE, 0, context.allREs, guideTable.ICsize);
+    LOG_OP(context, costs.alpha, std::string("Alpha"), static_cast<int>(context.alphabet.size()) + 2)
+
+    ExtraAtoms atoms(costs, maxCost, pos, neg, context.alphabet, seeds);
+    context.classAtoms = atoms.strings;
+
+    // The atoms as cheap as a character are checked with the alphabet
+    auto alphaAtoms = atoms.level(costs.alpha);
+    if (alphaAtoms.left < alphaAtoms.right) {
+        LOG_OP(context, costs.alpha, std::string("Atoms"), alphaAtoms.right - alphaAtoms.left)
+        context.checkedCost = costs.alpha;
+        if (seedAtoms(context, atoms, alphaAtoms) && !SolutionSet::collecting) {
+            intervals.setFinal(costs.alpha, Opreation::Concatenate);
+            return Result(context.REtoString(intervals), costs.alpha, context.allREs, guideTable.ICsize);
+        }
+        if (context.solutions.done(costs.alpha)) return solutionsResult(context, intervals, costs.alpha, guideTable.ICsize);
+    }
+
+    intervals.end(costs.alpha, Opreation::Concatenate) = context.lastIdx;
+    intervals.end(costs.alpha, Opreation::Or) = context.lastIdx;
+    intervals.end(costs.alpha, Opreation::And) = context.lastIdx;
+
+#ifdef MEET_IN_THE_MIDDLE
+    HostProjections projections(posBits, negBits, guideTable.ICsize);
+    // A lookup finds a single solution, it can't collect them
+    bool useMeetInTheMiddle = !SolutionSet::collecting && projections.fits();
+#endif
+    // Set when the lookups have covered every pair of Or and And in this cost
+    bool pairsLookedUp = false;
+
+    int shortageCost = -1; bool lastRound = false;
+    bool useQuestionOverOr = costs.alpha + costs.alternation >= costs.question;
+
+    // The launches of a level, in the order of the phases. Each one reads the intervals of its levels when it is made
+    auto planLevel = [&](int cost) {
+
+        std::vector<LaunchSpec> specs;
+
+        // Question mark
+        if (cost >= costs.alpha + costs.question && useQuestionOverOr) {
+            specs.push_back({ cost - costs.question, [&, cost]() -> Launch {
+                // ignore results from (*) and (?)
+                auto [start, end] = intervals.Interval(cost - costs.question, static_cast<Opreation>(2));
+                Pair<int> interval(start, end);
+                LOG_OP(context, cost, to_string(Opreation::Question), end - start)
+                return { Opreation::Question, unitCount(end - start), [&context, interval](int unit, TileResults& results) {
+                    QuestionMark(context, unitInterval(interval, unit), results);
+                }, false };
+            } });
+        }
+
+        // Star
+        if (cost >= costs.alpha + costs.star) {
+            specs.push_back({ cost - costs.star, [&, cost]() -> Launch {
+                // ignore results from (*) and (?)
+                auto [start, end] = intervals.Interval(cost - costs.star, static_cast<Opreation>(2));
+                Pair<int> interval(start, end);
+                LOG_OP(context, cost, to_string(Opreation::Star), end - start)
+                return { Opreation::Star, unitCount(end - start), [&context, &guideTable, interval](int unit, TileResults& results) {
+                    Star(context, guideTable, unitInterval(interval, unit), results);
+                }, false };
+            } });
+        }
+
+        // Character classes and seeds, they are stored with the concatenations
+        auto level = atoms.level(cost);
+        if (level.left < level.right) {
+            specs.push_back({ costs.alpha, [&, cost, level]() -> Launch {
+                LOG_OP(context, cost, std::string("Atoms"), level.right - level.left)
+                return { Opreation::Concatenate, 1, [&context, &atoms, level](int, TileResults& results) {
+                    Atoms(context, atoms, level, results);
+                }, false };
+            } });
+        }
+
+        //Concat
+        for (int i = costs.alpha; 2 * i <= cost - costs.concat; ++i) {
+            specs.push_back({ cost - i - costs.concat, [&, cost, i]() -> Launch {
+                auto [lstart, lend] = intervals.Interval(i);
+                auto [rstart, rend] = intervals.Interval(cost - i - costs.concat);
+
+                // every pair gives two candidates
+                paresy_s::TileScheduler tiles(Pair<int>(rstart, rend), Pair<int>(lstart, lend), hostTilePairs / 2);
+                LOG_OP(context, cost, to_string(Opreation::Concatenate), 2 * (rend - rstart) * (lend - lstart))
+                return { Opreation::Concatenate, tiles.count(), [&context, &guideTable, tiles](int unit, TileResults& results) {
+                    Concat(context, guideTable, tiles[unit], results);
+                }, false };
+            } });
+        }
+
+        //Or
+        if (!useQuestionOverOr && cost >= 2 * costs.alpha + costs.alternation) {
+            specs.push_back({ cost - costs.alpha - costs.alternation, [&, cost]() -> Launch {
+                auto [start, end] = intervals.Interval(cost - costs.alpha - costs.alternation);
+                Pair<int> interval(start, end);
+                LOG_OP(context, cost, to_string(Opreation::Or), end - start)
+                return { Opreation::Or, unitCount(end - start), [&context, interval](int unit, TileResults& results) {
+                    OrEpsilon(context, unitInterval(interval, unit), results);
+                }, false };
+            } });
+        }
+        for (int i = costs.alpha; 2 * i <= cost - costs.alternation; ++i) {
+            specs.push_back({ cost - i - costs.alternation, [&, cost, i]() -> Launch {
+                auto [lstart, lend] = intervals.Interval(i);
+                auto [rstart, rend] = intervals.Interval(cost - i - costs.alternation);
+
+                // Both sides are the same interval, (y, x) and (x, x) only give duplicates
+                if (2 * i == cost - costs.alternation) {
+                    LOG_OP(context, cost, to_string(Opreation::Or), static_cast<int>(triangularCount(lend - lstart)))
+                    return TriangleLaunch(context, Opreation::Or, Pair<int>(lstart, lend), orOp);
+                }
+
+                paresy_s::TileScheduler tiles(Pair<int>(rstart, rend), Pair<int>(lstart, lend), hostTilePairs);
+                LOG_OP(context, cost, to_string(Opreation::Or), (rend - rstart) * (lend - lstart))
+                return { Opreation::Or, tiles.count(), [&context, tiles](int unit, TileResults& results) {
+                    CrossProduct(context, tiles[unit], orOp, results);
+                }, true };
+            } });
+        }
+
+        //And
+        for (int i = costs.alpha; 2 * i <= cost - costs.intersection; ++i) {
+            specs.push_back({ cost - i - costs.intersection, [&, cost, i]() -> Launch {
+                auto [lstart, lend] = intervals.Interval(i);
+                auto [rstart, rend] = intervals.Interval(cost - i - costs.intersection);
+
+                if (2 * i == cost - costs.intersection) {
+                    LOG_OP(context, cost, to_string(Opreation::And), static_cast<int>(triangularCount(lend - lstart)))
+                    return TriangleLaunch(context, Opreation::And, Pair<int>(lstart, lend), andOp);
+                }
+
+                paresy_s::TileScheduler tiles(Pair<int>(rstart, rend), Pair<int>(lstart, lend), hostTilePairs);
+                LOG_OP(context, cost, to_string(Opreation::And), (rend - rstart) * (lend - lstart))
+                return { Opreation::And, tiles.count(), [&context, tiles](int unit, TileResults& results) {
+                    CrossProduct(context, tiles[unit], andOp, results);
+                }, true };
+            } });
+        }
+
+        return specs;
+    };
+
+    int cost{};
+    int planned = costs.alpha;
+
+    // Continuing after the last level of an interrupted run with the same examples
+    Checkpoint snapshot(checkpoint ? CHECKPOINT_DIR : "", costFun, pos, neg, seeds);
+    int resumed = snapshot.load(context, intervals, maxCost, shortageCost);
+    if (resumed != -1) {
+#if LOG_LEVEL >= 2
+        printf("Resuming after cost %d from the checkpoint\n", resumed);
+#endif
+        planned = resumed;
+    }
+    bool timedOut = false;
+
+    for (cost = planned + 1; cost <= maxCost; ++cost) {
+
+        // The next levels are planned ahead, their launches start as soon as the levels that they read are sealed
+        while (planned < std::min<int>(maxCost, cost + hostLookaheadLevels)) {
+            planned++;
+            scheduler.addLevel(planned, planLevel(planned));
+        }
+
+        // Once it uses a previous cost that is not fully stored, it should continue as the last round
+        if (context.onTheFly) {
+            int dif = cost - shortageCost;
+            if (dif == costs.question || dif == costs.star || dif == costs.alpha + costs.concat || dif == costs.alpha + costs.alternation || dif == costs.alpha + costs.intersection) lastRound = true;
+        }
+
+#ifdef MEET_IN_THE_MIDDLE
+        if (useMeetInTheMiddle) {
+            Opreation op;
+            if (meetInTheMiddle(context, projections, intervals, costs, cost, op)) {
+                intervals.setFinal(cost, op); goto exitEnumeration;
+            }
+            pairsLookedUp = true;
+        }
+#endif
+
+        // In "OnTheFly" mode the new REs are not stored, and the levels after lastReadCost are never read,
+        // so there is nothing left to do for the pairs that the lookups have covered
+        switch (scheduler.run(context, intervals, pairsLookedUp))
+        {
+        case LaunchStatus::Found:
+            goto exitEnumeration;
+        case LaunchStatus::TimeOut:
+            timedOut = true;
+            goto exitEnumeration;
+        default:
+            break;
+        }
+
+        if (lastRound || context.solutions.done(cost)) break;
+        if (context.onTheFly && shortageCost == -1) shortageCost = cost;
+        // the collected solutions are not in the snapshot, nor the levels whose pairs have been skipped
+        if (context.solutions.empty() && !(pairsLookedUp && cost > paresy_s::lastReadCost(costs, maxCost)))
+            snapshot.save(context, intervals, cost, shortageCost);
+    }
+
+    exitEnumeration:
+
+    // The snapshot is kept for the next run only when the time is up
+    if (!timedOut) snapshot.remove();
+
+    if (!context.solutions.empty()) return solutionsResult(context, intervals, cost, guideTable.ICsize);
+
+    if (context.isFound)
+    {
+#if LOG_LEVEL >= 2
+        if (context.onTheFly) { printf("\"OnTheFly\" mode has been used\n"); }
+#endif
+        RE = context.REtoString(intervals);
+        return Result(RE, cost, context.allREs, guideTable.ICsize);
+    }
+
+#if LOG_LEVEL >= 2
+    if (checkTime(startTime, maxTime))
+    { printf("exceeded the time limit %lf\n", maxTime); }
+    else if (cost > maxCost)
+    { printf("Max cost exceeded!\n"); }
+    else
+    { printf("memory limit exceeded, %lf mb of memory has been used.\n", available_memory / ((double)1024 * 1024)); }
+#endif
+
+    return Result("not_found", cost > maxCost ? maxCost : cost, context.allREs, guideTable.ICsize);
+}
+
+#ifdef HOST_ONLY
+paresy_s::Result paresy_s::REI(const unsigned short* costFun, const unsigned short maxCost, const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime,
+    const std::vector<Seed>& seeds) {
+
+#ifdef ALPHABET_CLASSES
+    // Enumerating over the representatives of the classes, they are expanded back in the output
+    AlphabetClasses classes(pos, neg);
+    if (classes.merged() && seeds.empty())
+    {
+#if LOG_LEVEL >= 2
+        printf("The alphabet has been compressed into classes\n");
+#endif
+        return classes.expandCost(hostEnumerate(costFun, maxCost, classes.project(pos), classes.project(neg), maxTime, classes, {}, true), costFun);
+    }
+#endif
+
+    return hostEnumerate(costFun, maxCost, pos, neg, maxTime, AlphabetClasses(), seeds, true);
+}
+
+paresy_s::Result paresy_s::REI(const HostExamples& examples, const unsigned short* costFun, const unsigned short maxCost,
+    const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime, const std::vector<Seed>& seeds, bool checkpoint) {
+
+#ifdef ALPHABET_CLASSES
+    // the infix-closure of the representatives is another one
+    AlphabetClasses classes(pos, neg);
+    if (seeds.empty() && classes.merged())
+    {
+        auto projectedPos = classes.project(pos), projectedNeg = classes.project(neg);
+        return classes.expandCost(hostEnumerate(costFun, maxCost, projectedPos, projectedNeg, maxTime, classes, {}, checkpoint), costFun);
+    }
+#endif
+
+    return hostEnumerate(examples, costFun, maxCost, pos, neg, maxTime, AlphabetClasses(), seeds, checkpoint);
+}
+
+std::vector<paresy_s::Result> paresy_s::REI(const std::vector<const unsigned short*>& costFuns, const unsigned short maxCost,
+    const std::vector<std::string>& pos, const std::vector<std::string>& neg, double maxTime) {
+
+#ifdef ALPHABET_CLASSES
+    AlphabetClasses classes(pos, neg);
+    if (classes.merged())
+    {
+        auto projectedPos = classes.project(pos), projectedNeg = classes.project(neg);
+        HostExamples examples(projectedPos, projectedNeg);
+        return enumerateBatch(costFuns, maxCost, [&](const unsigned short* costFun) {
+            return classes.expandCost(hostEnumerate(examples, costFun, maxCost, projectedPos, projectedNeg, maxTime, classes, {}, true), costFun);
+        });
+    }
+#endif
+
+    HostExamples examples(pos, neg);
+    return enumerateBatch(costFuns, maxCost, [&](const unsigned short* costFun) {
+        return hostEnumerate(examples, costFun, maxCost, pos, neg, maxTime, AlphabetClasses(), {}, true);
+    });
+}
+#endif
@@ -1,7 +1,73 @@
 #include <rei_util.hpp>
+#include <rei.h>
 #include <regex_match.hpp>
 
 #include <fstream>
+#include <thread>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <unordered_set>
+#include <unordered_map>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+std::set<std::string, paresy_s::strComparison> paresy_s::infixesOf(const std::string& word) {
+    std::set<std::string, strComparison> ic;
+    for (size_t len = 0; len <= word.length(); ++len) {
+        for (size_t index = 0; index < word.length() - len + 1; ++index) {
+            ic.insert(word.substr(index, len));
+        }
+    }
+    return ic;
+}
+
+std::set<std::string, paresy_s::strComparison> paresy_s::generatingIC(const std::vector<std::string>& pos, const std::vector<std::string>& neg) {
+    std::set<std::string, strComparison> ic = {};
+
+    for (const std::string& word : pos) {
+        std::set<std::string, strComparison> set1 = infixesOf(word);
+        ic.insert(set1.begin(), set1.end());
+    }
+    for (const std::string& word : neg) {
+        std::set<std::string, strComparison> set1 = infixesOf(word);
+        ic.insert(set1.begin(), set1.end());
+    }
+    return ic;
+}
+
+namespace {
+    thread_local const std::atomic<bool>* stopFlag = nullptr;
+}
+
+paresy_s::StopScope::StopScope(const std::atomic<bool>& stop) : previous(stopFlag)
+{
+    stopFlag = &stop;
+}
+
+paresy_s::StopScope::~StopScope()
+{
+    stopFlag = previous;
+}
+
+bool paresy_s::StopScope::stopped()
+{
+    return stopFlag && stopFlag->load(std::memory_order_relaxed);
+}
+
+bool paresy_s::checkTime(std::chrono::steady_clock::time_point startTime, double maxTime) {
+    if (StopScope::stopped()) return true;
+    auto duration = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - startTime).count();
+    return duration >= maxTime;
+}
 
 bool paresy_s::readStream(std::istream& stream, std::vector<std::string>& pos, std::vector<std::string>& neg) {
     std::string line;
@@ -29,15 +95,15 @@ bool paresy_s::readStream(std::istream& stream, std::vector<std::string>& pos, s
         }
     }
 
+    std::unordered_set<std::string> posSet(pos.begin(), pos.end());
+
     while (getline(stream, line)) {
         std::string word = "";
         for (auto c : line) if (c != ' ' && c != '"') word += c;
-        for (auto& p : pos) {
-            if (word == p) {
-                printf("\"%s\" is in both Pos and Neg examples", word.c_str());
-                printf("\nPlease check the input file, and remove one of those.\n");
-                return false;
-            }
+        if (posSet.count(word)) {
+            printf("\"%s\" is in both Pos and Neg examples", word.c_str());
+            printf("\nPlease check the input file, and remove one of those.\n");
+            return false;
         }
         neg.push_back(word);
     }
@@ -64,6 +130,286 @@ bool paresy_s::readFile(const std::string& fileName, std::vector<std::string>& p
 
 }
 
+paresy_s::MappedFile::MappedFile(const std::string& fileName) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return;
+    fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) return;
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+    opened = true;
+    if (size_ == 0) return;
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) { opened = false; return; }
+    mappingHandle = mapping;
+
+    data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr) opened = false;
+#else
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd == -1) return;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0) {
+        size_ = static_cast<size_t>(info.st_size);
+        opened = true;
+        if (size_ > 0) {
+            void* address = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address == MAP_FAILED) opened = false;
+            else {
+                data_ = static_cast<const char*>(address);
+                madvise(address, size_, MADV_SEQUENTIAL);
+            }
+        }
+    }
+    close(fd);
+#endif
+}
+
+paresy_s::MappedFile::~MappedFile() {
+#ifdef _WIN32
+    if (data_ != nullptr) UnmapViewOfFile(data_);
+    if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+    if (fileHandle != nullptr) CloseHandle(fileHandle);
+#else
+    if (data_ != nullptr) munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+paresy_s::SpillFile::SpillFile(size_t size) {
+    if (size == 0) return;
+    auto path = (std::filesystem::temp_directory_path() / "paresy-s-XXXXXX").string();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+        FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return;
+    fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    fileSize.QuadPart = static_cast<LONGLONG>(size);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, fileSize.HighPart, fileSize.LowPart, nullptr);
+    if (mapping == nullptr) return;
+    mappingHandle = mapping;
+
+    data_ = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size));
+    if (data_ != nullptr) size_ = size;
+#else
+    int fd = mkstemp(path.data());
+    if (fd == -1) return;
+    // the file is only reachable through the mapping
+    unlink(path.c_str());
+
+    if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+        void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (address != MAP_FAILED) {
+            data_ = static_cast<char*>(address);
+            size_ = size;
+        }
+    }
+    close(fd);
+#endif
+}
+
+paresy_s::SpillFile::~SpillFile() {
+#ifdef _WIN32
+    if (data_ != nullptr) UnmapViewOfFile(data_);
+    if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+    if (fileHandle != nullptr) CloseHandle(fileHandle);
+#else
+    if (data_ != nullptr) munmap(data_, size_);
+#endif
+}
+
+void paresy_s::SpillFile::prefetch(size_t offset, size_t length) const {
+#ifndef _WIN32
+    if (data_ == nullptr || length == 0) return;
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t start = offset / page * page;
+    madvise(data_ + start, std::min(offset + length, size_) - start, MADV_WILLNEED);
+#endif
+}
+
+void paresy_s::ExampleSet::toVectors(std::vector<std::string>& pos, std::vector<std::string>& neg) const {
+    pos.reserve(pos.size() + this->pos.size());
+    for (auto word : this->pos) pos.emplace_back(word);
+    neg.reserve(neg.size() + this->neg.size());
+    for (auto word : this->neg) neg.emplace_back(word);
+}
+
+// Files smaller than this are parsed on the calling thread
+const size_t parallelParseThreshold = 1 << 20;
+
+// A line without its line break, "\r\n" is accepted as well
+std::string_view lineAt(const char* begin, const char* end, const char*& next) {
+    auto lineEnd = static_cast<const char*>(memchr(begin, '\n', end - begin));
+    if (lineEnd == nullptr) { lineEnd = end; next = end; }
+    else next = lineEnd + 1;
+    if (lineEnd != begin && *(lineEnd - 1) == '\r') lineEnd--;
+    return std::string_view(begin, lineEnd - begin);
+}
+
+// Removing the quotes and the spaces. The result is a view into the line if the word is contiguous,
+// otherwise the characters are copied to the pool
+std::string_view parseWord(std::string_view line, char*& pool) {
+    size_t first = line.find_first_not_of(" \"");
+    if (first == std::string_view::npos) return std::string_view();
+    size_t last = line.find_last_not_of(" \"");
+
+    auto word = line.substr(first, last - first + 1);
+    if (word.find_first_of(" \"") == std::string_view::npos) return word;
+
+    char* begin = pool;
+    for (auto c : word) if (c != ' ' && c != '"') *pool++ = c;
+    return std::string_view(begin, pool - begin);
+}
+
+struct ParsedChunk {
+    std::vector<std::string_view> words;
+    size_t lines = 0;
+};
+
+void parseChunk(const char* begin, const char* end, char* pool, ParsedChunk& chunk) {
+    while (begin < end) {
+        const char* next;
+        auto line = lineAt(begin, end, next);
+        chunk.words.push_back(parseWord(line, pool));
+        chunk.lines++;
+        begin = next;
+    }
+}
+
+// Parsing the lines of [begin, end) into words, the region is cut into chunks at line breaks
+void parseRegion(const char* begin, const char* end, size_t firstLine, unsigned int threadCount,
+    std::vector<std::unique_ptr<char[]>>& pools, std::vector<std::string_view>& words, std::vector<size_t>& lines) {
+
+    size_t size = end - begin;
+    if (size == 0) return;
+
+    unsigned int chunkCount = size < parallelParseThreshold ? 1 : threadCount;
+
+    std::vector<const char*> cuts = { begin };
+    for (unsigned int i = 1; i < chunkCount; ++i) {
+        const char* cut = std::max(cuts.back(), begin + size * i / chunkCount);
+        auto lineBreak = static_cast<const char*>(memchr(cut, '\n', end - cut));
+        cuts.push_back(lineBreak == nullptr ? end : lineBreak + 1);
+    }
+    cuts.push_back(end);
+
+    std::vector<ParsedChunk> chunks(chunkCount);
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < chunkCount; ++i) {
+        // the pool never needs more than the chunk itself, so the views into it stay valid
+        pools.emplace_back(new char[cuts[i + 1] - cuts[i] + 1]);
+        char* pool = pools.back().get();
+        if (chunkCount == 1) parseChunk(cuts[i], cuts[i + 1], pool, chunks[i]);
+        else threads.emplace_back(parseChunk, cuts[i], cuts[i + 1], pool, std::ref(chunks[i]));
+    }
+    for (auto& t : threads) t.join();
+
+    size_t line = firstLine;
+    for (auto& chunk : chunks) {
+        for (size_t i = 0; i < chunk.words.size(); ++i) {
+            words.push_back(chunk.words[i]);
+            lines.push_back(line + i);
+        }
+        line += chunk.lines;
+    }
+}
+
+// Keeping the first occurrence of each word
+void removeDuplicates(std::vector<std::string_view>& words, std::vector<size_t>& lines,
+    std::unordered_map<std::string_view, size_t>& firstLine, const char* name) {
+
+    firstLine.reserve(words.size());
+    size_t j = 0;
+    for (size_t i = 0; i < words.size(); ++i) {
+        auto [it, inserted] = firstLine.emplace(words[i], lines[i]);
+        if (!inserted) {
+            printf("\"%.*s\" at line %zu is a duplicate of line %zu in %s examples, it will be ignored.\n",
+                static_cast<int>(words[i].size()), words[i].data(), lines[i], it->second, name);
+            continue;
+        }
+        words[j] = words[i];
+        lines[j] = lines[i];
+        j++;
+    }
+    words.resize(j);
+    lines.resize(j);
+}
+
+bool paresy_s::readMappedFile(const std::string& fileName, ExampleSet& examples, unsigned int threadCount) {
+
+    examples.file.reset(new MappedFile(fileName));
+    if (!examples.file->isOpen()) {
+        printf("Unable to open the file");
+        return false;
+    }
+
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    const char* begin = examples.file->data();
+    const char* end = begin + examples.file->size();
+
+    // Finding the "++" and the "--" lines
+    const char* posBegin = nullptr;
+    const char* posEnd = nullptr;
+    const char* negBegin = nullptr;
+    size_t line = 0, posFirstLine = 0;
+
+    for (const char* it = begin; it < end;) {
+        const char* next;
+        auto current = lineAt(it, end, next);
+        line++;
+        if (posBegin == nullptr) {
+            if (current == "++") { posBegin = next; posFirstLine = line + 1; }
+        }
+        else if (current == "--") {
+            posEnd = it; negBegin = next; break;
+        }
+        it = next;
+    }
+
+    if (posBegin == nullptr) {
+        printf("Unable to find \"++\" for positive words");
+        printf("\nPlease check the input file.\n");
+        return false;
+    }
+    if (posEnd == nullptr) {
+        printf("Unable to find \"--\" for negative words");
+        printf("\nPlease check the input file.\n");
+        return false;
+    }
+
+    parseRegion(posBegin, posEnd, posFirstLine, threadCount, examples.pools, examples.pos, examples.posLines);
+    parseRegion(negBegin, end, line + 1, threadCount, examples.pools, examples.neg, examples.negLines);
+
+    std::unordered_map<std::string_view, size_t> posFirstLines, negFirstLines;
+    removeDuplicates(examples.pos, examples.posLines, posFirstLines, "Pos");
+    removeDuplicates(examples.neg, examples.negLines, negFirstLines, "Neg");
+
+    for (size_t i = 0; i < examples.neg.size(); ++i) {
+        auto it = posFirstLines.find(examples.neg[i]);
+        if (it != posFirstLines.end()) {
+            printf("\"%.*s\" is in both Pos (line %zu) and Neg (line %zu) examples",
+                static_cast<int>(examples.neg[i].size()), examples.neg[i].data(), it->second, examples.negLines[i]);
+            printf("\nPlease check the input file, and remove one of those.\n");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool paresy_s::readMappedFile(const std::string& fileName, std::vector<std::string>& pos, std::vector<std::string>& neg) {
+    ExampleSet examples;
+    if (!readMappedFile(fileName, examples)) return false;
+    examples.toVectors(pos, neg);
+    return true;
+}
+
  void  count(shared_ptr<Regex> node, paresy_s::OperationsCount& counts) {
      if (!node) return;
      if (auto altr = dynamic_cast<Or*>(node.get())) {
@@ -89,9 +435,12 @@ bool paresy_s::readFile(const std::string& fileName, std::vector<std::string>& p
          counts.question++;
          count(question->node, counts);
      }
-     else if (auto character = dynamic_cast<Char*>(node.get())) {
+     else if (dynamic_cast<Char*>(node.get())) {
          counts.alpha++;
      }
+     else if (dynamic_cast<CharClass*>(node.get())) {
+         counts.charClass++;
+     }
      else {
          printf("Unknown type\n");
      }
@@ -0,0 +1,94 @@
+#include <seed_atoms.hpp>
+
+#include <cstdio>
+#include <numeric>
+#include <algorithm>
+
+#include <regex_match.hpp>
+#include <re_string.hpp>
+#include <char_classes.hpp>
+
+using paresy_s::HostGuideTable;
+
+namespace {
+
+    CS evaluate(const Regex& node, const HostGuideTable& guideTable, const std::set<char>& alphabet)
+    {
+        if (auto ch = dynamic_cast<const Char*>(&node)) return paresy_s::charClassCS<CS>(alphabet, std::string(1, ch->c));
+        if (auto cls = dynamic_cast<const CharClass*>(&node)) return paresy_s::charClassCS<CS>(alphabet, cls->chars);
+        if (auto question = dynamic_cast<const Optional*>(&node)) return paresy_s::hostQuestion(evaluate(*question->node, guideTable, alphabet));
+        if (auto star = dynamic_cast<const Star*>(&node)) return paresy_s::hostStar(guideTable, evaluate(*star->node, guideTable, alphabet));
+        if (auto concat = dynamic_cast<const Concat*>(&node))
+            return paresy_s::hostConcatenate(guideTable, evaluate(*concat->left, guideTable, alphabet), evaluate(*concat->right, guideTable, alphabet));
+        if (auto alternation = dynamic_cast<const Or*>(&node))
+            return evaluate(*alternation->left, guideTable, alphabet) | evaluate(*alternation->right, guideTable, alphabet);
+
+        auto& intersection = dynamic_cast<const And&>(node);
+        return evaluate(*intersection.left, guideTable, alphabet) & evaluate(*intersection.right, guideTable, alphabet);
+    }
+
+}
+
+CS paresy_s::seedCS(const std::string& RE, const HostGuideTable& guideTable, const std::set<char>& alphabet)
+{
+    Parser parser(RE);
+    return evaluate(*parser.parse(), guideTable, alphabet);
+}
+
+paresy_s::ExtraAtoms::ExtraAtoms(const Costs& costs, int maxCost, const std::vector<std::string>& pos, const std::vector<std::string>& neg,
+    const std::set<char>& alphabet, const std::vector<Seed>& seeds)
+{
+    std::vector<std::string> unsorted;
+    std::vector<CS> unsortedCSs;
+
+    if (costs.charClass > 0 && costs.charClass <= maxCost) {
+        for (auto& members : usefulCharClasses(pos, neg, CHAR_CLASS_MAX_COUNT)) {
+            unsorted.push_back(charClassString(members));
+            unsortedCSs.push_back(charClassCS<CS>(alphabet, members));
+            this->costs.push_back(costs.charClass);
+        }
+    }
+
+    if (!seeds.empty()) {
+        HostGuideTable guideTable(generatingIC(pos, neg));
+
+        for (auto& seed : seeds) {
+            int cost = std::max(seed.cost, costs.alpha);
+            // empty and epsilon are checked before the enumeration
+            if (cost > maxCost || seed.RE == "eps" || seed.RE == "Empty") continue;
+
+            try {
+                unsortedCSs.push_back(seedCS(seed.RE, guideTable, alphabet));
+            }
+            catch (const std::runtime_error&) {
+#if LOG_LEVEL >= 2
+                printf("The seed %s can't be parsed, it is left out\n", seed.RE.c_str());
+#endif
+                continue;
+            }
+            // it is an operand like an atom in the output, without the operators around it binding into it
+            unsorted.push_back(bracket(seed.RE));
+            this->costs.push_back(cost);
+        }
+    }
+
+    // The classes stay first within their level
+    std::vector<int> order(unsorted.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return this->costs[a] < this->costs[b]; });
+
+    std::vector<int> sortedCosts;
+    for (int i : order) {
+        strings.push_back(unsorted[i]);
+        css.push_back(unsortedCSs[i]);
+        sortedCosts.push_back(this->costs[i]);
+    }
+    this->costs.swap(sortedCosts);
+}
+
+paresy_s::Pair<int> paresy_s::ExtraAtoms::level(int cost) const
+{
+    auto first = std::lower_bound(costs.begin(), costs.end(), cost);
+    auto last = std::upper_bound(first, costs.end(), cost);
+    return { static_cast<int>(first - costs.begin()), static_cast<int>(last - costs.begin()) };
+}
@@ -0,0 +1,71 @@
+#include <worker_pool.hpp>
+
+#include <algorithm>
+
+using paresy_s::WorkerPool;
+
+WorkerPool::WorkerPool(int threads)
+{
+    if (threads <= 0) threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int i = 1; i < threads; ++i) workers.emplace_back(&WorkerPool::work, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void WorkerPool::pull()
+{
+    for (int i = next.fetch_add(1); i < count; i = next.fetch_add(1)) (*task)(i);
+}
+
+void WorkerPool::run(int count, const std::function<void(int)>& task)
+{
+    if (count <= 0) return;
+
+    // A single unit is not worth waking the workers up
+    if (workers.empty() || count == 1) {
+        for (int i = 0; i < count; ++i) task(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->task = &task;
+        this->count = count;
+        next = 0;
+        busy = static_cast<int>(workers.size());
+        generation++;
+    }
+    wake.notify_all();
+
+    pull();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return busy == 0; });
+    this->task = nullptr;
+}
+
+void WorkerPool::work()
+{
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stop || generation != seen; });
+            if (stop) return;
+            seen = generation;
+        }
+
+        pull();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0) done.notify_one();
+    }
+}
@@ -0,0 +1,17 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <cstdio>
+
+// The tests are plain executables, a failed check is printed and makes main return 1
+inline int failedChecks = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            failedChecks++; \
+        } \
+    } while (false)
+
+#endif // CHECK_HPP
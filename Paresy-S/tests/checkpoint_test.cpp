@@ -0,0 +1,128 @@
+#include <checkpoint.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+#include "check.hpp"
+
+using paresy_s::Opreation;
+
+const int opCount = static_cast<int>(Opreation::Count);
+
+// A context past its initial check with a few levels of random REs
+struct Run {
+    paresy_s::HostExamples examples;
+    paresy_s::HostContext context;
+    paresy_s::CostIntervals intervals;
+
+    Run(const std::vector<std::string>& pos, const std::vector<std::string>& neg, int maxCost)
+        : examples(pos, neg), context(1 << 12, examples.posBits, examples.negBits), intervals(maxCost) {
+        std::string RE;
+        context.intialCheck(pos, neg, paresy_s::AlphabetClasses(), RE);
+    }
+
+    // The levels after from up to levels
+    void fill(std::mt19937& rng, int levels, int from = 0) {
+        for (int cost = from + 1; cost <= levels; ++cost) {
+            for (int op = 0; op < opCount; ++op) {
+                intervals.start(cost, static_cast<Opreation>(op)) = static_cast<int>(context.lastIdx);
+                for (int i = 0; i < 10; ++i) {
+                    CS cs;
+                    for (int ix = 0; ix < examples.guideTable.ICsize; ++ix) if (rng() % 2) cs.set(ix);
+                    // a solution is kept aside, it isn't in the snapshot
+                    if (context.isSolution(cs)) continue;
+                    int ldx = static_cast<int>(rng() % (context.lastIdx + 1)), rdx = static_cast<int>(rng() % (context.lastIdx + 1));
+                    context.insert(cs, ldx, rdx);
+                }
+            }
+        }
+        intervals.end(levels, Opreation::And) = static_cast<int>(context.lastIdx);
+        context.allREs = 12345;
+    }
+};
+
+// The arrays, the intervals up to levels and the counters of a loaded run are the ones of the saved run
+void checkSame(const Run& loaded, const Run& saved, int levels) {
+    CHECK(loaded.context.lastIdx == saved.context.lastIdx);
+    CHECK(loaded.context.allREs == saved.context.allREs);
+    CHECK(loaded.context.leftIdx == saved.context.leftIdx);
+    CHECK(loaded.context.rightIdx == saved.context.rightIdx);
+    CHECK(loaded.context.visited.size() == saved.context.visited.size());
+    for (uint64_t i = 0; i < saved.context.lastIdx; ++i) CHECK(loaded.context.langCache[i] == saved.context.langCache[i]);
+    for (int cost = 0; cost <= levels; ++cost)
+        for (int op = 0; op < opCount; ++op)
+            CHECK(loaded.intervals.start(cost, static_cast<Opreation>(op)) == saved.intervals.start(cost, static_cast<Opreation>(op)));
+    CHECK(loaded.intervals.end(levels, Opreation::And) == saved.intervals.end(levels, Opreation::And));
+}
+
+int main() {
+    auto directory = std::filesystem::temp_directory_path() / "paresy-s-checkpoint-test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    std::vector<std::string> pos = { "ab", "abab", "b" }, neg = { "a", "ba", "abb" };
+    unsigned short costFun[6] = { 1, 1, 1, 1, 1, 1 }, otherCostFun[6] = { 1, 2, 1, 1, 1, 1 };
+    int maxCost = 20, levels = 4;
+
+    std::mt19937 rng(17);
+    Run saved(pos, neg, maxCost);
+    saved.fill(rng, levels);
+
+    paresy_s::Checkpoint checkpoint(directory.string(), costFun, pos, neg, {});
+    CHECK(checkpoint.save(saved.context, saved.intervals, levels, 7));
+
+    // The same arrays, intervals and counters come back
+    Run loaded(pos, neg, maxCost);
+    int shortageCost = -1;
+    CHECK(checkpoint.load(loaded.context, loaded.intervals, maxCost, shortageCost) == levels);
+    CHECK(shortageCost == 7);
+    checkSame(loaded, saved, levels);
+
+    // The next saves append their levels, after a save and after a load
+    saved.fill(rng, levels + 2, levels);
+    CHECK(checkpoint.save(saved.context, saved.intervals, levels + 2, 7));
+    paresy_s::Checkpoint resumed(directory.string(), costFun, pos, neg, {});
+    Run appended(pos, neg, maxCost);
+    CHECK(resumed.load(appended.context, appended.intervals, maxCost, shortageCost) == levels + 2);
+    checkSame(appended, saved, levels + 2);
+
+    int last = levels + 3;
+    saved.fill(rng, last, levels + 2);
+    CHECK(resumed.save(saved.context, saved.intervals, last, 8));
+    Run reloaded(pos, neg, maxCost);
+    CHECK(checkpoint.load(reloaded.context, reloaded.intervals, maxCost, shortageCost) == last);
+    CHECK(shortageCost == 8);
+    checkSame(reloaded, saved, last);
+
+    // What an interrupted save has left after the records is not read
+    auto file = std::filesystem::directory_iterator(directory)->path();
+    std::ofstream(file, std::ios::binary | std::ios::app) << "torn record";
+    Run torn(pos, neg, maxCost);
+    CHECK(checkpoint.load(torn.context, torn.intervals, maxCost, shortageCost) == last);
+    checkSame(torn, saved, last);
+
+    // Another cost function or a max cost that the snapshot has reached doesn't see it
+    Run other(pos, neg, maxCost);
+    paresy_s::Checkpoint otherCheckpoint(directory.string(), otherCostFun, pos, neg, {});
+    CHECK(otherCheckpoint.load(other.context, other.intervals, maxCost, shortageCost) == -1);
+    CHECK(checkpoint.load(other.context, other.intervals, last, shortageCost) == -1);
+
+    checkpoint.remove();
+    CHECK(checkpoint.load(other.context, other.intervals, maxCost, shortageCost) == -1);
+
+    // Only CHECKPOINT_KEEP snapshots are left of the runs with other cost functions, the last one among them
+    paresy_s::Checkpoint lastRun(directory.string(), costFun, pos, neg, {});
+    for (unsigned short c = 1; c <= CHECKPOINT_KEEP + 2; ++c) {
+        unsigned short runCostFun[6] = { c, 1, 1, 1, 1, 1 };
+        lastRun = paresy_s::Checkpoint(directory.string(), runCostFun, pos, neg, {});
+        CHECK(lastRun.save(saved.context, saved.intervals, last, 7));
+    }
+    auto files = std::distance(std::filesystem::directory_iterator(directory), std::filesystem::directory_iterator());
+    CHECK(files == CHECKPOINT_KEEP);
+    CHECK(lastRun.load(other.context, other.intervals, maxCost, shortageCost) == last);
+
+    std::filesystem::remove_all(directory);
+    return failedChecks == 0 ? 0 : 1;
+}
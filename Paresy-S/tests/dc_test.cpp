@@ -0,0 +1,105 @@
+#include <rei_dc.hpp>
+#include <rei_host.hpp>
+#include <regex_match.hpp>
+#include <worker_pool.hpp>
+
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+
+bool consistent(const std::string& RE, const std::vector<std::string>& pos, const std::vector<std::string>& neg) {
+    if (RE == "not_found") return false;
+    for (bool accepted : match(pos, RE)) if (!accepted) return false;
+    for (bool accepted : match(neg, RE)) if (accepted) return false;
+    return true;
+}
+
+// The words over {a, b} up to length, split by a target RE
+void examplesOf(const std::string& target, int length, std::vector<std::string>& pos, std::vector<std::string>& neg) {
+    std::vector<std::string> words = { "" };
+    for (size_t i = 0; i < words.size(); ++i)
+        if (static_cast<int>(words[i].size()) < length) { words.push_back(words[i] + "a"); words.push_back(words[i] + "b"); }
+    for (auto& word : words) (::match(target, word) ? pos : neg).push_back(word);
+}
+
+int main() {
+    unsigned short costFun[6] = { 1, 1, 1, 1, 1, 1 };
+    const unsigned short maxCost = 40;
+    const double maxTime = 10;
+
+    for (auto target : { "(ab)*", "a(a+b)*b", "(a+b)*bb(a+b)*" }) {
+        std::vector<std::string> pos, neg;
+        examplesOf(target, 5, pos, neg);
+
+        for (int threads : { 1, 4 }) {
+            paresy_s::RecursiveProfileInfo profileInfo;
+            auto RE = paresy_s::mergeSplit(8, costFun, maxCost, pos, neg, maxTime, profileInfo, paresy_s::hostSolver, threads);
+            CHECK(consistent(RE, pos, neg));
+        }
+
+        // The words of length 6 are added to an RE of the shorter ones
+        std::vector<std::string> allPos, allNeg, newPos, newNeg;
+        examplesOf(target, 6, allPos, allNeg);
+        for (auto& word : allPos) if (word.size() == 6) newPos.push_back(word);
+        for (auto& word : allNeg) if (word.size() == 6) newNeg.push_back(word);
+
+        paresy_s::RecursiveProfileInfo profileInfo;
+        auto previous = paresy_s::randSplit(8, costFun, maxCost, pos, neg, maxTime, profileInfo, paresy_s::hostSolver);
+        CHECK(consistent(previous, pos, neg));
+
+        // a previous RE that already fits the new words is kept as it is
+        auto repaired = paresy_s::repairRE(previous, 8, costFun, maxCost, pos, neg, newPos, newNeg, maxTime, profileInfo, paresy_s::hostSolver);
+        CHECK(consistent(repaired, allPos, allNeg));
+        if (consistent(previous, allPos, allNeg)) CHECK(repaired == previous);
+
+        // an RE that accepts everything is patched
+        auto patched = paresy_s::repairRE("(a+b)*", 8, costFun, maxCost, {}, {}, allPos, allNeg, maxTime, profileInfo, paresy_s::hostSolver);
+        CHECK(consistent(patched, allPos, allNeg));
+    }
+
+    // The shares of the leaves nest, and the budget of the thread is whole again after them
+    {
+        paresy_s::ResourceShare leaves(4);
+        {
+            paresy_s::ResourceShare samples(2);
+            CHECK(paresy_s::ResourceShare::parts() == 8);
+        }
+        CHECK(paresy_s::ResourceShare::parts() == 4);
+    }
+    CHECK(paresy_s::ResourceShare::parts() == 1);
+
+    // A task on a thread of a pool starts from the share of the thread that has submitted it
+    {
+        paresy_s::ResourceShare leaves(2);
+        int inherited = paresy_s::ResourceShare::parts();
+        paresy_s::WorkerPool pool(3);
+        std::vector<int> parts(6, 0), after(6, 0);
+        pool.run(6, [&](int i) {
+            {
+                paresy_s::ResourceShare samples(inherited, 3);
+                parts[i] = paresy_s::ResourceShare::parts();
+            }
+            after[i] = paresy_s::ResourceShare::parts();
+        });
+        for (int i = 0; i < 6; ++i) CHECK(parts[i] == 6);
+        // the workers are back to their own budget, the calling thread to the one of leaves
+        for (int i = 0; i < 6; ++i) CHECK(after[i] == 1 || after[i] == 2);
+    }
+
+    // A stopped enumeration gives up at its first check of the time, the flag is only seen on its own thread
+    {
+        std::vector<std::string> pos, neg;
+        examplesOf("a(a+b)*b", 4, pos, neg);
+        std::atomic<bool> stop(true);
+        {
+            paresy_s::StopScope scope(stop);
+            CHECK(paresy_s::StopScope::stopped());
+            CHECK(paresy_s::hostSolver(paresy_s::HostExamples(pos, neg), costFun, maxCost, pos, neg, maxTime, {}, false).RE == "not_found");
+        }
+        CHECK(!paresy_s::StopScope::stopped());
+        CHECK(consistent(paresy_s::hostSolver(paresy_s::HostExamples(pos, neg), costFun, maxCost, pos, neg, maxTime, {}, false).RE, pos, neg));
+    }
+
+    return failedChecks == 0 ? 0 : 1;
+}
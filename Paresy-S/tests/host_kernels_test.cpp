@@ -0,0 +1,113 @@
+#include <rei_host.hpp>
+#include <bit_sliced.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "check.hpp"
+
+using paresy_s::HostGuideTable;
+
+// The operations on the words themselves: w is in L1.L2 when it is uv with u in L1 and v in L2,
+// and in L* when it is empty or a non-empty prefix in L followed by a word of L*
+struct Languages {
+    std::vector<std::string> words;
+    std::unordered_map<std::string, int> index;
+
+    Languages(const std::set<std::string, paresy_s::strComparison>& ic) : words(ic.begin(), ic.end()) {
+        for (int i = 0; i < static_cast<int>(words.size()); ++i) index[words[i]] = i;
+    }
+
+    CS concatenate(const CS& left, const CS& right) const {
+        CS res;
+        for (int ix = 0; ix < static_cast<int>(words.size()); ++ix)
+            for (size_t i = 0; i <= words[ix].size(); ++i)
+                if (left.test(index.at(words[ix].substr(0, i))) && right.test(index.at(words[ix].substr(i)))) { res.set(ix); break; }
+        return res;
+    }
+
+    // the words are in the order of their length, so the rest of a word is decided before the word
+    CS star(const CS& cs) const {
+        CS res = CS::one();
+        for (int ix = 1; ix < static_cast<int>(words.size()); ++ix)
+            for (size_t i = 1; i <= words[ix].size(); ++i)
+                if (cs.test(index.at(words[ix].substr(0, i))) && res.test(index.at(words[ix].substr(i)))) { res.set(ix); break; }
+        return res;
+    }
+};
+
+std::vector<std::string> randomWords(std::mt19937& rng, int count, int maxLength) {
+    std::vector<std::string> words;
+    for (int i = 0; i < count; ++i) {
+        std::string word;
+        int length = static_cast<int>(rng() % (maxLength + 1));
+        for (int j = 0; j < length; ++j) word += "abc"[rng() % 3];
+        words.push_back(word);
+    }
+    return words;
+}
+
+CS randomCS(std::mt19937& rng, int ICsize, int density) {
+    CS cs;
+    for (int ix = 0; ix < ICsize; ++ix) if (static_cast<int>(rng() % 100) < density) cs.set(ix);
+    return cs;
+}
+
+void checkTranspose(std::mt19937& rng) {
+    uint64_t rows[64], original[64];
+    for (auto& row : original) row = (static_cast<uint64_t>(rng()) << 32) | rng();
+    std::copy(original, original + 64, rows);
+    paresy_s::transpose64(rows);
+    for (int i = 0; i < 64; ++i)
+        for (int k = 0; k < 64; ++k) CHECK(((original[k] >> i) & 1) == ((rows[i] >> k) & 1));
+}
+
+void checkKernels(std::mt19937& rng) {
+    auto ic = paresy_s::generatingIC(randomWords(rng, 6, 6), randomWords(rng, 6, 6));
+    if (ic.size() > sizeof(CS) * 8) return;
+
+    HostGuideTable guideTable(ic);
+    Languages languages(ic);
+    int ICsize = guideTable.ICsize;
+
+    std::vector<CS> lefts, rights;
+    paresy_s::BitSlicedBatch left(ICsize), right(ICsize), lr(ICsize), rl(ICsize);
+    for (int k = 0; k < paresy_s::BitSlicedBatch::width; ++k) {
+        lefts.push_back(randomCS(rng, ICsize, k % 50));
+        rights.push_back(randomCS(rng, ICsize, 50 - k % 50));
+        for (int ix = 0; ix < ICsize; ++ix) {
+            if (lefts[k].test(ix)) left[ix] |= (uint64_t)1 << k;
+            if (rights[k].test(ix)) right[ix] |= (uint64_t)1 << k;
+        }
+    }
+
+    for (int k = 0; k < paresy_s::BitSlicedBatch::width; ++k) {
+        CHECK(paresy_s::hostQuestion(lefts[k]) == (lefts[k] | CS::one()));
+        CHECK(paresy_s::hostConcatenate(guideTable, lefts[k], rights[k]) == languages.concatenate(lefts[k], rights[k]));
+        CHECK(paresy_s::hostStar(guideTable, lefts[k]) == languages.star(lefts[k]));
+    }
+
+    std::vector<CS> slicedLR(64), slicedRL(64), slicedStar(64);
+    paresy_s::slicedConcatenate(guideTable, left, right, lr, rl);
+    lr.store(slicedLR.data(), 64);
+    rl.store(slicedRL.data(), 64);
+    paresy_s::slicedStar(guideTable, left);
+    left.store(slicedStar.data(), 64);
+
+    for (int k = 0; k < paresy_s::BitSlicedBatch::width; ++k) {
+        CHECK(slicedLR[k] == languages.concatenate(lefts[k], rights[k]));
+        CHECK(slicedRL[k] == languages.concatenate(rights[k], lefts[k]));
+        CHECK(slicedStar[k] == languages.star(lefts[k]));
+    }
+}
+
+int main() {
+    std::mt19937 rng(11);
+
+    for (int round = 0; round < 20; ++round) checkTranspose(rng);
+    for (int round = 0; round < 50; ++round) checkKernels(rng);
+
+    return failedChecks == 0 ? 0 : 1;
+}
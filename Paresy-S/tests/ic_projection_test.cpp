@@ -0,0 +1,69 @@
+#include <ic_projection.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+
+std::vector<std::string> randomWords(std::mt19937& rng, int count, int maxLength) {
+    std::vector<std::string> words;
+    for (int i = 0; i < count; ++i) {
+        std::string word;
+        int length = static_cast<int>(rng() % (maxLength + 1));
+        for (int j = 0; j < length; ++j) word += "abcd"[rng() % 4];
+        words.push_back(word);
+    }
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    return words;
+}
+
+std::vector<std::string> sample(std::mt19937& rng, const std::vector<std::string>& words) {
+    std::vector<std::string> res;
+    for (auto& word : words) if (rng() % 2) res.push_back(word);
+    return res;
+}
+
+bool sameExamples(const paresy_s::HostExamples& a, const paresy_s::HostExamples& b) {
+    if (a.fits != b.fits) return false;
+    if (!a.fits) return true;
+    if (a.guideTable.ICsize != b.guideTable.ICsize || a.guideTable.alphabetSize != b.guideTable.alphabetSize) return false;
+    if (a.posBits != b.posBits || a.negBits != b.negBits) return false;
+
+    for (int ix = 0; ix < a.guideTable.ICsize; ++ix) {
+        if (a.guideTable.rowEnd(ix) - a.guideTable.rowBegin(ix) != b.guideTable.rowEnd(ix) - b.guideTable.rowBegin(ix)) return false;
+        for (auto x = a.guideTable.rowBegin(ix), y = b.guideTable.rowBegin(ix); x != a.guideTable.rowEnd(ix); ++x, ++y)
+            if (x->left != y->left || x->right != y->right) return false;
+    }
+    return true;
+}
+
+// The projection of the root infix-closure against the one generated from the words of the sub-problem
+int main() {
+    std::mt19937 rng(5);
+
+    for (int round = 0; round < 200; ++round) {
+        auto words = randomWords(rng, 40, round % 2 ? 6 : 12);
+        std::vector<std::string> pos, neg;
+        for (auto& word : words) (rng() % 2 ? pos : neg).push_back(word);
+
+        paresy_s::ICProjection ic(pos, neg);
+        auto subPos = sample(rng, pos), subNeg = sample(rng, neg);
+
+        CHECK(sameExamples(ic.project(subPos, subNeg), paresy_s::HostExamples(subPos, subNeg)));
+
+        // The closure of a growing sample counts the words of its infix-closure
+        paresy_s::SampleClosure closure(ic, INT_MAX);
+        std::vector<std::string> added;
+        for (auto& word : subPos) {
+            CHECK(closure.add(word));
+            added.push_back(word);
+            CHECK(closure.size() == static_cast<int>(paresy_s::generatingIC(added, {}).size()));
+        }
+    }
+
+    return failedChecks == 0 ? 0 : 1;
+}
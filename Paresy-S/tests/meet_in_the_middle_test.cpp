@@ -0,0 +1,88 @@
+#include <meet_in_the_middle.hpp>
+
+#include <random>
+#include <vector>
+
+#include "check.hpp"
+
+using paresy_s::Pair;
+using paresy_s::Projection;
+
+uint64_t randomKey(std::mt19937_64& rng, int width, int density) {
+    uint64_t key = 0;
+    for (int bit = 0; bit < width; ++bit)
+        if (static_cast<int>(rng() % 100) < density) key |= (uint64_t)1 << bit;
+    return key;
+}
+
+// The index against a scan of all the keys, on the table and on the trie
+void checkProjectionIndex(std::mt19937_64& rng, int width, int keyCount, int density) {
+    paresy_s::ProjectionIndex index(width);
+    std::vector<uint64_t> keys;
+    for (int i = 0; i < keyCount; ++i) {
+        keys.push_back(randomKey(rng, width, density));
+        index.add(keys.back(), i);
+    }
+    index.build();
+
+    for (int q = 0; q < 2000; ++q) {
+        uint64_t need = randomKey(rng, width, q % 2 ? density / 2 : density);
+        bool exists = false;
+        for (auto key : keys) exists |= (key & need) == need;
+
+        int found = index.findSuperset(need);
+        CHECK((found != -1) == exists);
+        if (found != -1) CHECK((keys[found] & need) == need);
+    }
+}
+
+// The lookups against all the pairs of the two intervals
+void checkLookups(std::mt19937_64& rng, int posCount, int negCount) {
+    uint64_t allPos = posCount == 64 ? ~(uint64_t)0 : ((uint64_t)1 << posCount) - 1;
+    uint64_t allNeg = negCount == 64 ? ~(uint64_t)0 : ((uint64_t)1 << negCount) - 1;
+
+    for (int round = 0; round < 200; ++round) {
+        std::vector<Projection> projections;
+        for (int i = 0; i < 60; ++i) {
+            Projection p = { randomKey(rng, posCount, 70), randomKey(rng, negCount, 10) };
+            if (rng() % 3 == 0) p.neg = 0;
+            if (rng() % 3 == 0) p.pos = allPos;
+            projections.push_back(p);
+        }
+        Pair<int> left(0, 25), right(25, 60);
+
+        bool orExists = false, andExists = false;
+        for (int i = left.left; i < left.right; ++i)
+            for (int j = right.left; j < right.right; ++j) {
+                auto& a = projections[i]; auto& b = projections[j];
+                orExists |= (a.pos | b.pos) == allPos && (a.neg | b.neg) == 0;
+                andExists |= (a.pos & b.pos) == allPos && (a.neg & b.neg & allNeg) == 0;
+            }
+
+        auto alternation = paresy_s::findAlternation(projections.data(), left, right, posCount);
+        CHECK((alternation.left != -1) == orExists);
+        if (alternation.left != -1) {
+            auto& a = projections[alternation.left]; auto& b = projections[alternation.right];
+            CHECK((a.pos | b.pos) == allPos && (a.neg | b.neg) == 0);
+        }
+
+        auto intersection = paresy_s::findIntersection(projections.data(), left, right, posCount, negCount);
+        CHECK((intersection.left != -1) == andExists);
+        if (intersection.left != -1) {
+            auto& a = projections[intersection.left]; auto& b = projections[intersection.right];
+            CHECK((a.pos & b.pos) == allPos && (a.neg & b.neg) == 0);
+        }
+    }
+}
+
+int main() {
+    std::mt19937_64 rng(7);
+
+    for (int width : { 1, 8, paresy_s::ProjectionIndex::maxTableWidth, 17, 40, 64 })
+        for (int density : { 20, 50, 80 })
+            checkProjectionIndex(rng, width, 500, density);
+
+    for (int count : { 6, 16, 30, 64 }) checkLookups(rng, count, count);
+
+    return failedChecks == 0 ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+#include <re_string.hpp>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "check.hpp"
+
+using paresy_s::Pair;
+using paresy_s::Provenance;
+
+// The REs that the roots are made of, following the arrays one RE at a time
+std::set<int> reachable(const std::vector<Pair<int>>& roots, int alphabetSize, const std::vector<int>& left, const std::vector<int>& right) {
+    std::set<int> seen;
+    std::vector<int> stack;
+    for (auto& root : roots) { stack.push_back(root.left); stack.push_back(root.right); }
+    while (!stack.empty()) {
+        int index = stack.back(); stack.pop_back();
+        if (index < alphabetSize || !seen.insert(index).second) continue;
+        stack.push_back(left[index]);
+        stack.push_back(right[index]);
+    }
+    return seen;
+}
+
+// Synthetic arrays: every RE points to cheaper ones, the unary ones and the atoms have negative indices
+int main() {
+    std::mt19937 rng(13);
+
+    for (int round = 0; round < 200; ++round) {
+        int alphabetSize = 1 + static_cast<int>(rng() % 5);
+        int size = alphabetSize + static_cast<int>(rng() % 2000);
+
+        std::vector<int> left(size, -1), right(size, -1);
+        for (int i = alphabetSize; i < size; ++i) {
+            left[i] = static_cast<int>(rng() % (i + 3)) - 3;
+            right[i] = rng() % 3 ? static_cast<int>(rng() % (i + 3)) - 3 : -1;
+        }
+
+        std::vector<Pair<int>> roots;
+        for (int r = 0, n = 1 + static_cast<int>(rng() % 4); r < n; ++r)
+            roots.push_back({ static_cast<int>(rng() % size), static_cast<int>(rng() % size) });
+
+        auto expected = reachable(roots, alphabetSize, left, right);
+
+        Provenance provenance(roots, alphabetSize, left.data(), right.data());
+        CHECK(provenance.size() == expected.size() + roots.size());
+        for (int index : expected) {
+            CHECK(provenance.left(index) == left[index]);
+            CHECK(provenance.right(index) == right[index]);
+        }
+        for (size_t r = 0; r < roots.size(); ++r) {
+            CHECK(provenance.left(Provenance::rootIndex(static_cast<int>(r))) == roots[r].left);
+            CHECK(provenance.right(Provenance::rootIndex(static_cast<int>(r))) == roots[r].right);
+        }
+
+        // Every RE is fetched once, with the other ones of its depth
+        std::vector<int> fetched;
+        Provenance fetchedProvenance(roots, alphabetSize, [&](const std::vector<int>& indices, std::vector<int>& l, std::vector<int>& r) {
+            for (size_t i = 0; i < indices.size(); ++i) {
+                fetched.push_back(indices[i]);
+                l[i] = left[indices[i]];
+                r[i] = right[indices[i]];
+            }
+        });
+        std::sort(fetched.begin(), fetched.end());
+        CHECK(std::vector<int>(expected.begin(), expected.end()) == fetched);
+        CHECK(fetchedProvenance.size() == provenance.size());
+    }
+
+    return failedChecks == 0 ? 0 : 1;
+}
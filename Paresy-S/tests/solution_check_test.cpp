@@ -0,0 +1,35 @@
+#include <cs.h>
+#include <solution_check.h>
+
+#include <random>
+
+#include "check.hpp"
+
+CS randomCS(std::mt19937& rng, int density) {
+    CS cs;
+    for (int ix = 0; ix < static_cast<int>(sizeof(CS) * 8); ++ix) if (static_cast<int>(rng() % 1000) < density) cs.set(ix);
+    return cs;
+}
+
+// The check on the words with examples against the whole masks
+int main() {
+    std::mt19937 rng(3);
+
+    for (int round = 0; round < 100; ++round) {
+        CS posBits = randomCS(rng, 10), negBits = randomCS(rng, 10) & ~posBits;
+        paresy_s::SolutionCheck<CS> check(posBits, negBits);
+
+        for (int i = 0; i < 200; ++i) {
+            CS cs = randomCS(rng, 500);
+            // most of the random ones are rejected, so some are made into solutions and then broken on a word
+            if (i % 2) {
+                cs = (cs | posBits) & ~negBits;
+                if (i % 4 == 1) cs.set(static_cast<int>(rng() % (sizeof(CS) * 8)));
+            }
+            bool expected = (cs & posBits) == posBits && (~cs & negBits) == negBits;
+            CHECK(check(cs) == expected);
+        }
+    }
+
+    return failedChecks == 0 ? 0 : 1;
+}